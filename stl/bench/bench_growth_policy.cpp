@@ -0,0 +1,88 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+// vector 各个增长策略（growth_policy.h）的内存和吞吐量对比
+// 用法：bench_growth_policy [最大元素个数，默认 1<<24] [重复次数，默认 3]
+// 从 1000 开始每次乘以 10 直到最大元素个数，对每个策略逐个 push_back 到 n 个 uint64_t，输出：
+//     realloc  重新分配的次数
+//     cap/n    最后的容量和元素个数之比（多出来的就是浪费的内存）
+//     peak     增长过程中同时存在的新旧两块空间的最大字节数和 n 个元素字节数之比
+//     ns/push  每次 push_back 的平均时间
+// exact_growth 每次 push_back 都要重新分配和搬移，是平方复杂度，只在 n 不超过 1<<17 时测试
+
+#include <cstdint>
+#include <cstdio>
+
+#include "bench_util.h"
+#include "allocator.h"
+#include "growth_policy.h"
+#include "vector.h"
+
+namespace
+{
+    const size_t kExactLimit = static_cast<size_t>(1) << 17;
+
+    template <class Growth>
+    void run(const char* name, size_t n, int reps)
+    {
+        typedef mystl::vector<uint64_t, mystl::allocator<uint64_t>, Growth> vec;
+
+        // 第一次只统计容量的变化，不计时
+        size_t reallocs = 0;
+        size_t peak = 0;
+        size_t cap = 0;
+        {
+            vec v;
+            size_t last = v.capacity();
+            for (size_t i = 0; i < n; ++i)
+            {
+                v.push_back(i);
+                if (v.capacity() != last)
+                {
+                    const size_t both = v.capacity() + (last != 0 ? last : 0);
+                    peak = both > peak ? both : peak;
+                    last = v.capacity();
+                    ++reallocs;
+                }
+            }
+            cap = v.capacity();
+        }
+
+        const double t = bench::time_best(reps, [&]() {
+            vec v;
+            for (size_t i = 0; i < n; ++i)
+            {
+                v.push_back(i);
+            }
+            bench::do_not_optimize(v[n - 1]);
+        });
+
+        std::printf("%-22s %8zu %8.3f %8.3f %10.2f\n", name, reallocs,
+                    static_cast<double>(cap) / static_cast<double>(n),
+                    static_cast<double>(peak) / static_cast<double>(n),
+                    t * 1e9 / static_cast<double>(n));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t max_n = bench::arg_size(argc, argv, 1, static_cast<size_t>(1) << 24);
+    const int reps = static_cast<int>(bench::arg_size(argc, argv, 2, 3));
+
+    for (size_t n = 1000; n <= max_n; n *= 10)
+    {
+        std::printf("n = %zu, best of %d\n", n, reps);
+        std::printf("%-22s %8s %8s %8s %10s\n", "policy", "realloc", "cap/n", "peak", "ns/push");
+        run<mystl::default_growth>("default_growth (2x)", n, reps);
+        run<mystl::half_growth>("half_growth (1.5x)", n, reps);
+        run<mystl::size_class_growth<mystl::default_growth>>("size_class<2x>", n, reps);
+        run<mystl::size_class_growth<mystl::half_growth>>("size_class<1.5x>", n, reps);
+        if (n <= kExactLimit)
+        {
+            run<mystl::exact_growth>("exact_growth", n, reps);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
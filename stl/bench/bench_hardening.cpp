@@ -0,0 +1,115 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+// 各个检查级别（hardening.h）下元素访问的开销
+// 用法：bench_hardening [元素个数，默认 1<<22] [重复次数，默认 20]
+// 同一份源文件按 MYSTL_HARDENING_LEVEL = 0、1、2 编译成 bench_hardening、bench_hardening_l1、bench_hardening_l2，
+// 分别用裸指针、vector 的下标和迭代器、deque 的下标和迭代器对 uint64_t 求和，输出时间和相对裸指针的倍数
+// level 0 时 vector 的两列应当和裸指针相同（倍数约为 1.00），这就是“level 0 没有额外开销”的验证
+
+#include <cstdint>
+#include <cstdio>
+
+#include "bench_util.h"
+#include "deque.h"
+#include "hardening.h"
+#include "vector.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+namespace
+{
+    BENCH_NOINLINE uint64_t sum_pointer(const uint64_t* p, size_t n)
+    {
+        uint64_t s = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            s += p[i];
+        }
+        return s;
+    }
+
+    template <class Container>
+    BENCH_NOINLINE uint64_t sum_index(const Container& c)
+    {
+        uint64_t s = 0;
+        const size_t n = c.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            s += c[i];
+        }
+        return s;
+    }
+
+    template <class Container>
+    BENCH_NOINLINE uint64_t sum_iterator(const Container& c)
+    {
+        uint64_t s = 0;
+        for (auto it = c.begin(), last = c.end(); it != last; ++it)
+        {
+            s += *it;
+        }
+        return s;
+    }
+
+    template <class Fn>
+    double run(int reps, uint64_t& check, Fn fn)
+    {
+        return bench::time_best(reps, [&]() {
+            const uint64_t s = fn();
+            bench::do_not_optimize(s);
+            check = s;
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t n = bench::arg_size(argc, argv, 1, static_cast<size_t>(1) << 22);
+    const int reps = static_cast<int>(bench::arg_size(argc, argv, 2, 20));
+
+    mystl::vector<uint64_t> v(n);
+    mystl::deque<uint64_t> d(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        v[i] = i;
+        d[i] = i;
+    }
+
+    // 先各读一遍，避免第一个计时的函数因为缓存和 TLB 是冷的而偏慢
+    uint64_t expect = sum_pointer(&v[0], n);
+    bench::do_not_optimize(sum_index(d));
+    const double raw = run(reps, expect, [&]() { return sum_pointer(&v[0], n); });
+
+    struct row
+    {
+        const char* name;
+        double      time;
+        uint64_t    sum;
+    };
+    row rows[4];
+    rows[0].name = "vector[i]";
+    rows[0].time = run(reps, rows[0].sum, [&]() { return sum_index(v); });
+    rows[1].name = "vector iterator";
+    rows[1].time = run(reps, rows[1].sum, [&]() { return sum_iterator(v); });
+    rows[2].name = "deque[i]";
+    rows[2].time = run(reps, rows[2].sum, [&]() { return sum_index(d); });
+    rows[3].name = "deque iterator";
+    rows[3].time = run(reps, rows[3].sum, [&]() { return sum_iterator(d); });
+
+    std::printf("MYSTL_HARDENING_LEVEL = %d, n = %zu, best of %d\n", MYSTL_HARDENING_LEVEL, n, reps);
+    std::printf("%-16s %12s %10s\n", "access", "time(s)", "vs raw");
+    std::printf("%-16s %12.6f %10.2f\n", "raw pointer", raw, 1.0);
+    bool ok = true;
+    for (const row& r : rows)
+    {
+        std::printf("%-16s %12.6f %10.2f\n", r.name, r.time, r.time / raw);
+        ok = ok && r.sum == expect;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+// hugepage_allocator 和 allocator 在大缓冲区顺序扫描时的对比
+// 用法：bench_hugepage_scan [缓冲区字节数，默认 1 GiB] [扫描次数，默认 5]
+// 两种分配器各自构造一个 vector<uint64_t>（第一次写入，统计缺页次数），再顺序求和扫描若干次取最短的一次；
+// 输出时间、带宽、缺页次数（getrusage 的 minflt/majflt），Linux 上还输出进程中透明大页的大小（AnonHugePages）
+// 两个 vector 依次构造、析构，同一时刻只占用一份内存
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "bench_util.h"
+#include "allocator.h"
+#include "hugepage_allocator.h"
+#include "vector.h"
+
+namespace
+{
+    struct fault_count
+    {
+        long minor;
+        long major;
+    };
+
+    fault_count faults()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return {usage.ru_minflt, usage.ru_majflt};
+#else
+        return {0, 0};
+#endif
+    }
+
+    // 进程中透明大页的 KiB 数，读不到时返回 -1
+    long anon_huge_kib()
+    {
+        long kib = -1;
+#if defined(__linux__)
+        FILE* f = std::fopen("/proc/self/smaps_rollup", "r");
+        if (f == nullptr)
+        {
+            return kib;
+        }
+        char line[256];
+        while (std::fgets(line, sizeof(line), f) != nullptr)
+        {
+            if (std::strncmp(line, "AnonHugePages:", 14) == 0)
+            {
+                kib = std::strtol(line + 14, nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(f);
+#endif
+        return kib;
+    }
+
+    template <class Alloc>
+    void run(const char* name, size_t count, int reps)
+    {
+        const fault_count before = faults();
+        const bench::clock::time_point start = bench::clock::now();
+        mystl::vector<uint64_t, Alloc> v(count);
+        const double fill = bench::seconds_since(start);
+        const fault_count after = faults();
+        const long huge = anon_huge_kib();
+
+        uint64_t sum = 0;
+        const double scan = bench::time_best(reps, [&]() {
+            uint64_t s = 0;
+            const uint64_t* p = v.begin();
+            for (size_t i = 0; i < count; ++i)
+            {
+                s += p[i];
+            }
+            sum += s;
+        });
+        bench::do_not_optimize(sum);
+
+        const double gib = static_cast<double>(count * sizeof(uint64_t)) / (1024.0 * 1024.0 * 1024.0);
+        std::printf("%-20s %10.4f %10ld %8ld %12ld %10.4f %10.2f\n",
+                    name, fill, after.minor - before.minor, after.major - before.major, huge, scan, gib / scan);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t bytes = bench::arg_size(argc, argv, 1, static_cast<size_t>(1) << 30);
+    const int reps = static_cast<int>(bench::arg_size(argc, argv, 2, 5));
+    const size_t count = bytes / sizeof(uint64_t);
+
+    std::printf("buffer = %zu bytes, scan best of %d\n", count * sizeof(uint64_t), reps);
+    std::printf("%-20s %10s %10s %8s %12s %10s %10s\n",
+                "allocator", "fill(s)", "minflt", "majflt", "thp(KiB)", "scan(s)", "GiB/s");
+    run<mystl::allocator<uint64_t>>("allocator", count, reps);
+    run<mystl::hugepage_allocator<uint64_t>>("hugepage_allocator", count, reps);
+    return 0;
+}
@@ -0,0 +1,115 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+// 默认构造不分配内存（惰性分配）对“很多成员大多为空”的结构体的效果
+// 用法：bench_lazy_alloc [记录个数，默认 100000] [重复次数，默认 3]
+// 每条记录有 kMembers 个 vector 或 deque 成员，构造所有记录后只往每条记录的第一个成员放一个元素，再全部析构；
+// 用计数的分配器统计分配次数和字节数，和 std::vector、std::deque 对比（libstdc++ 的 std::deque 默认构造就会分配）
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include "bench_util.h"
+#include "allocator.h"
+#include "deque.h"
+#include "vector.h"
+
+namespace
+{
+    const size_t kMembers = 16;
+
+    std::atomic<size_t> g_allocs(0);
+    std::atomic<size_t> g_bytes(0);
+
+    // 统计分配次数和字节数，其余和 mystl::allocator 相同
+    template <class T>
+    struct counting_allocator : public mystl::allocator<T>
+    {
+        template <class U>
+        struct rebind
+        {
+            typedef counting_allocator<U> other;
+        };
+
+        counting_allocator() noexcept = default;
+
+        template <class U>
+        counting_allocator(const counting_allocator<U>&) noexcept {}
+
+        static T* allocate(size_t n)
+        {
+            record(n);
+            return mystl::allocator<T>::allocate(n);
+        }
+
+        static mystl::allocation_result<T*> allocate_at_least(size_t n)
+        {
+            const mystl::allocation_result<T*> r = mystl::allocator<T>::allocate_at_least(n);
+            record(r.count);
+            return r;
+        }
+
+    private:
+        static void record(size_t n) noexcept
+        {
+            g_allocs.fetch_add(1, std::memory_order_relaxed);
+            g_bytes.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const counting_allocator<T>&, const counting_allocator<U>&) noexcept { return true; }
+
+    template <class T, class U>
+    bool operator!=(const counting_allocator<T>&, const counting_allocator<U>&) noexcept { return false; }
+
+    template <class Container>
+    struct record
+    {
+        Container members[kMembers];
+    };
+
+    template <class Container>
+    void run(const char* name, size_t count, int reps)
+    {
+        typedef record<Container> rec;
+        size_t allocs = 0;
+        size_t bytes = 0;
+        const double t = bench::time_best(reps, [&]() {
+            g_allocs.store(0);
+            g_bytes.store(0);
+            {
+                mystl::vector<rec> records(count);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    records[i].members[0].push_back(static_cast<uint64_t>(i));
+                }
+                bench::do_not_optimize(records.begin());
+            }
+            allocs = g_allocs.load();
+            bytes = g_bytes.load();
+        });
+        std::printf("%-14s %10.4f %14zu %14zu %10.2f\n", name, t, allocs, bytes,
+                    static_cast<double>(bytes) / static_cast<double>(count));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t count = bench::arg_size(argc, argv, 1, 100000);
+    const int reps = static_cast<int>(bench::arg_size(argc, argv, 2, 3));
+
+    std::printf("records = %zu, members per record = %zu, one element in the first member, best of %d\n",
+                count, kMembers, reps);
+    std::printf("%-14s %10s %14s %14s %10s\n", "container", "time(s)", "allocations", "bytes", "bytes/rec");
+    run<mystl::vector<uint64_t, counting_allocator<uint64_t>>>("mystl::vector", count, reps);
+    run<std::vector<uint64_t, counting_allocator<uint64_t>>>("std::vector", count, reps);
+    run<mystl::deque<uint64_t, counting_allocator<uint64_t>>>("mystl::deque", count, reps);
+    run<std::deque<uint64_t, counting_allocator<uint64_t>>>("std::deque", count, reps);
+    return 0;
+}
@@ -0,0 +1,89 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+// list 节点分配的吞吐量：allocator、pool_allocator、magazine_allocator（node_cache.h）在 1、4、16、64 个线程下的对比
+// 用法：bench_node_cache [每个线程的分配次数，默认 1<<20] [每批的节点数，默认 64] [重复次数，默认 3]
+// 每个线程持有自己的 list，反复 push_back 一批节点再全部 pop_front，所有线程同时开始；
+// 输出每秒的分配次数（所有线程合计）以及相对 allocator 的倍数，线程数超过 CPU 数时线程会轮流运行
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "bench_util.h"
+#include "allocator.h"
+#include "list.h"
+#include "node_cache.h"
+#include "pool_allocator.h"
+#include "vector.h"
+
+namespace
+{
+    template <class Alloc>
+    double run(size_t threads, size_t ops, size_t batch, int reps)
+    {
+        return bench::time_best(reps, [&]() {
+            std::atomic<size_t> ready(0);
+            std::atomic<bool> go(false);
+            mystl::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([&]() {
+                    mystl::list<uint64_t, Alloc> l;
+                    ready.fetch_add(1);
+                    while (!go.load(std::memory_order_acquire))
+                    {
+                        std::this_thread::yield();
+                    }
+                    for (size_t done = 0; done < ops; done += batch)
+                    {
+                        for (size_t i = 0; i < batch; ++i)
+                        {
+                            l.push_back(i);
+                        }
+                        for (size_t i = 0; i < batch; ++i)
+                        {
+                            l.pop_front();
+                        }
+                    }
+                });
+            }
+            while (ready.load() != threads)
+            {
+                std::this_thread::yield();
+            }
+            go.store(true, std::memory_order_release);
+            for (size_t t = 0; t < threads; ++t)
+            {
+                workers[t].join();
+            }
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t ops = bench::arg_size(argc, argv, 1, static_cast<size_t>(1) << 20);
+    size_t batch = bench::arg_size(argc, argv, 2, 64);
+    const int reps = static_cast<int>(bench::arg_size(argc, argv, 3, 3));
+    batch = batch != 0 ? batch : 1;
+    const size_t thread_counts[] = {1, 4, 16, 64};
+
+    std::printf("allocations per thread = %zu, batch = %zu, hardware_concurrency = %u, best of %d\n",
+                ops, batch, std::thread::hardware_concurrency(), reps);
+    std::printf("%-8s %14s %14s %8s %14s %8s\n",
+                "threads", "allocator/s", "pool/s", "x", "magazine/s", "x");
+    for (size_t threads : thread_counts)
+    {
+        // 实际的分配次数：每个线程 ops 向上取整到 batch 的倍数
+        const double total = static_cast<double>(threads * ((ops + batch - 1) / batch * batch));
+        const double base = total / run<mystl::allocator<uint64_t>>(threads, ops, batch, reps);
+        const double pool = total / run<mystl::pool_allocator<uint64_t>>(threads, ops, batch, reps);
+        const double mag = total / run<mystl::magazine_allocator<uint64_t>>(threads, ops, batch, reps);
+        std::printf("%-8zu %14.3e %14.3e %8.2f %14.3e %8.2f\n",
+                    threads, base, pool, pool / base, mag, mag / base);
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+// numa_allocator 各个策略的内存带宽
+// 用法：bench_numa_bandwidth [缓冲区字节数，默认 1 GiB] [线程数，默认 hardware_concurrency] [扫描次数，默认 5]
+// 对 local、interleave 以及 bind 到每一个节点，用 numa_allocator 分配一块缓冲区，
+// 每个线程（Linux 上绑定到第 i 个 CPU）先写入（首次访问）再反复读取自己的一段，输出最好一次的读带宽；
+// 再用同样的分配器构造同样大小的 deque，按同样的方式测量，并用 get_mempolicy 检查每个缓冲区（约 4 KiB）
+// 所在的映射是否设置了对应的策略，输出设置了策略的缓冲区个数
+// 只有一个节点时各个策略没有区别，直接输出说明并退出
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "bench_util.h"
+#include "deque.h"
+#include "numa_allocator.h"
+#include "vector.h"
+
+namespace
+{
+    void pin_to_cpu(size_t cpu)
+    {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(static_cast<int>(cpu % CPU_SETSIZE), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+
+    // threads 个线程，第 i 个处理 [n * i / threads, n * (i + 1) / threads)
+    template <class Fn>
+    void run_threads(size_t threads, size_t n, Fn fn)
+    {
+        mystl::vector<std::thread> workers;
+        for (size_t i = 0; i < threads; ++i)
+        {
+            workers.emplace_back([=]() {
+                pin_to_cpu(i);
+                fn(i, n * i / threads, n * (i + 1) / threads);
+            });
+        }
+        for (size_t i = 0; i < threads; ++i)
+        {
+            workers[i].join();
+        }
+    }
+
+    typedef mystl::numa_allocator<uint64_t>   numa_alloc;
+    typedef mystl::deque<uint64_t, numa_alloc> numa_deque;
+
+    // ptr 所在映射的策略是否为 policy（没有 get_mempolicy 时无法检查，返回 false）
+    bool has_policy(const void* ptr, mystl::numa_policy policy)
+    {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+        const unsigned long MPOL_F_ADDR_ = 2;
+        int mode = -1;
+        if (::syscall(SYS_get_mempolicy, &mode, nullptr, 0UL, ptr, MPOL_F_ADDR_) != 0)
+        {
+            return false;
+        }
+        switch (policy)
+        {
+            case mystl::numa_policy::local:
+                // 较早的内核把 MPOL_LOCAL 记为没有节点的 MPOL_PREFERRED
+                return mode == mystl::numa_impl::MPOL_LOCAL_ || mode == mystl::numa_impl::MPOL_PREFERRED_;
+            case mystl::numa_policy::interleave:
+                return mode == mystl::numa_impl::MPOL_INTERLEAVE_;
+            case mystl::numa_policy::bind:
+                return mode == mystl::numa_impl::MPOL_BIND_;
+        }
+        return false;
+#else
+        (void)ptr;
+        (void)policy;
+        return false;
+#endif
+    }
+
+    void print(const char* name, const char* container, size_t count, double t, const char* placed)
+    {
+        const double gib = static_cast<double>(count * sizeof(uint64_t)) / (1024.0 * 1024.0 * 1024.0);
+        std::printf("%-14s %-8s %10.4f %10.2f %s\n", name, container, t, gib / t, placed);
+    }
+
+    void run_deque(const char* name, const numa_alloc& alloc, size_t count, size_t threads, int reps)
+    {
+        // 构造函数在当前线程中初始化所有元素，local 策略下页面都在当前线程的节点上，之后各线程再写入自己的一段
+        numa_deque d(count, alloc);
+        run_threads(threads, count, [&d](size_t, size_t lo, size_t hi) {
+            auto it = d.begin() + static_cast<ptrdiff_t>(lo);
+            for (size_t i = lo; i < hi; ++i, ++it)
+            {
+                *it = i;
+            }
+        });
+
+        mystl::vector<uint64_t> sums(threads, 0);
+        const double t = bench::time_best(reps, [&]() {
+            run_threads(threads, count, [&d, &sums](size_t t, size_t lo, size_t hi) {
+                uint64_t s = 0;
+                auto it = d.begin() + static_cast<ptrdiff_t>(lo);
+                for (size_t i = lo; i < hi; ++i, ++it)
+                {
+                    s += *it;
+                }
+                sums[t] += s;
+            });
+        });
+        bench::do_not_optimize(sums[0]);
+
+        // 每个缓冲区检查一次
+        size_t buffers = 0;
+        size_t placed = 0;
+        for (size_t i = 0; i < count; i += numa_deque::buffer_size)
+        {
+            ++buffers;
+            placed += has_policy(&d[i], alloc.policy()) ? 1 : 0;
+        }
+        char text[64];
+        std::snprintf(text, sizeof(text), "%zu/%zu buffers", placed, buffers);
+        print(name, "deque", count, t, text);
+    }
+
+    void run(const char* name, const numa_alloc& alloc, size_t count, size_t threads, int reps)
+    {
+        uint64_t* p = numa_alloc(alloc).allocate(count);
+        run_threads(threads, count, [p](size_t, size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i)
+            {
+                p[i] = i;
+            }
+        });
+
+        mystl::vector<uint64_t> sums(threads, 0);
+        const double t = bench::time_best(reps, [&]() {
+            run_threads(threads, count, [p, &sums](size_t t, size_t lo, size_t hi) {
+                uint64_t s = 0;
+                for (size_t i = lo; i < hi; ++i)
+                {
+                    s += p[i];
+                }
+                sums[t] += s;
+            });
+        });
+        bench::do_not_optimize(sums[0]);
+        const char* placed = has_policy(p, alloc.policy()) ? "yes" : "no";
+        numa_alloc(alloc).deallocate(p, count);
+        print(name, "buffer", count, t, placed);
+        run_deque(name, alloc, count, threads, reps);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int nodes = mystl::numa_impl::node_count();
+    if (nodes < 2)
+    {
+        std::printf("%d NUMA node online: every numa_policy behaves like local, nothing to compare\n", nodes);
+        return 0;
+    }
+
+    const size_t bytes = bench::arg_size(argc, argv, 1, static_cast<size_t>(1) << 30);
+    size_t threads = bench::arg_size(argc, argv, 2, std::thread::hardware_concurrency());
+    const int reps = static_cast<int>(bench::arg_size(argc, argv, 3, 5));
+    threads = threads != 0 ? threads : 1;
+    const size_t count = bytes / sizeof(uint64_t);
+
+    std::printf("nodes = %d, buffer = %zu bytes, threads = %zu, best of %d\n",
+                nodes, count * sizeof(uint64_t), threads, reps);
+    std::printf("%-14s %-8s %10s %10s %s\n", "policy", "memory", "read(s)", "GiB/s", "policy set");
+    run("local", numa_alloc(mystl::numa_policy::local), count, threads, reps);
+    run("interleave", numa_alloc(mystl::numa_policy::interleave), count, threads, reps);
+    for (int node = 0; node < nodes; ++node)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "bind(%d)", node);
+        run(name, numa_alloc(mystl::numa_policy::bind, node), count, threads, reps);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+// 并行 sort / merge 从 1 个线程到 N 个线程的扩展性
+// 用法：bench_parallel_sort [元素个数，默认 1<<24] [最大线程数，默认 hardware_concurrency] [重复次数，默认 3]
+// 对同一份随机的 uint64_t 数据，分别用 seq 和 par.with_threads(t)（t = 1, 2, 4, ..., N）排序 vector 和 deque，
+// 再归并排好的两半，输出耗时和相对 seq 的加速比，并检查每个线程数的结果都和 seq 相同（输出是确定的）
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "bench_util.h"
+#include "deque.h"
+#include "parallel_algo.h"
+#include "vector.h"
+
+namespace
+{
+    typedef mystl::vector<uint64_t> vec;
+
+    bool same(const vec& a, const vec& b)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i] != b[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class Container>
+    bool same(const Container& a, const vec& b)
+    {
+        size_t i = 0;
+        for (auto it = a.begin(); it != a.end(); ++it, ++i)
+        {
+            if (*it != b[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t n = bench::arg_size(argc, argv, 1, static_cast<size_t>(1) << 24);
+    size_t max_threads = bench::arg_size(argc, argv, 2, std::thread::hardware_concurrency());
+    const int reps = static_cast<int>(bench::arg_size(argc, argv, 3, 3));
+    max_threads = max_threads != 0 ? max_threads : 1;
+
+    vec input(n);
+    bench::rng rng(42);
+    for (size_t i = 0; i < n; ++i)
+    {
+        input[i] = rng();
+    }
+
+    // 顺序的结果作为基准和对照
+    vec expect;
+    const double seq_sort = bench::time_best(reps, [&]() { expect = input; }, [&]() {
+        mystl::sort(mystl::execution::seq, expect.begin(), expect.end());
+    });
+
+    // 两半分别排好，作为 merge 的输入
+    const size_t half = n / 2;
+    vec left(input.begin(), input.begin() + half);
+    vec right(input.begin() + half, input.end());
+    mystl::sort(left.begin(), left.end());
+    mystl::sort(right.begin(), right.end());
+    vec merged(n);
+    const double seq_merge = bench::time_best(reps, [&]() {
+        mystl::merge(mystl::execution::seq, left.begin(), left.end(), right.begin(), right.end(), merged.begin());
+    });
+
+    std::printf("n = %zu, hardware_concurrency = %u, best of %d\n", n, std::thread::hardware_concurrency(), reps);
+    std::printf("%-8s %12s %8s %12s %8s %12s %8s %s\n",
+                "threads", "vector(s)", "speedup", "deque(s)", "speedup", "merge(s)", "speedup", "result");
+    std::printf("%-8s %12.4f %8.2f %12s %8s %12.4f %8.2f\n", "seq", seq_sort, 1.0, "-", "-", seq_merge, 1.0);
+
+    bool all_ok = true;
+    for (size_t t = 1; ; t = t * 2 < max_threads ? t * 2 : max_threads)
+    {
+        const mystl::execution::parallel_policy policy = mystl::execution::par.with_threads(t);
+
+        vec v;
+        const double vt = bench::time_best(reps, [&]() { v = input; }, [&]() {
+            mystl::sort(policy, v.begin(), v.end());
+        });
+
+        mystl::deque<uint64_t> d(n);
+        const double dt = bench::time_best(reps, [&]() { mystl::copy(input.begin(), input.end(), d.begin()); }, [&]() {
+            mystl::sort(policy, d.begin(), d.end());
+        });
+
+        vec m(n);
+        const double mt = bench::time_best(reps, [&]() {
+            mystl::merge(policy, left.begin(), left.end(), right.begin(), right.end(), m.begin());
+        });
+
+        const bool ok = same(v, expect) && same(d, expect) && same(m, expect);
+        all_ok = all_ok && ok;
+        std::printf("%-8zu %12.4f %8.2f %12.4f %8.2f %12.4f %8.2f %s\n",
+                    t, vt, seq_sort / vt, dt, seq_sort / dt, mt, seq_merge / mt, ok ? "ok" : "MISMATCH");
+        if (t == max_threads)
+        {
+            break;
+        }
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+// radix_sort 和比较排序 mystl::sort 的对比
+// 用法：bench_radix_sort [元素个数，默认 1<<24] [线程数，默认 hardware_concurrency] [重复次数，默认 3]
+// 对几种键分布分别用 mystl::sort、radix_sort 和 radix_sort(par.with_threads(线程数)) 排序同一份数据，
+// 输出耗时和相对 mystl::sort 的倍数，并检查 radix_sort 的结果和 mystl::sort 相同
+//     uint64 random   均匀分布的 64 位整数
+//     uint64 < 2^20   只有低 20 位不同（高位全相同的轮次被跳过）
+//     uint32 random   32 位整数
+//     int64 random    有符号整数，正负各半
+//     double random   [-1e9, 1e9) 的浮点数
+//     record by key   16 字节的结构体，按其中的 uint64_t 成员排序
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "bench_util.h"
+#include "algorithm.h"
+#include "parallel_algo.h"
+#include "radix_sort.h"
+#include "vector.h"
+
+namespace
+{
+    struct record
+    {
+        uint64_t key;
+        uint64_t payload;
+    };
+
+    struct record_key
+    {
+        uint64_t operator()(const record& r) const noexcept { return r.key; }
+    };
+
+    struct record_less
+    {
+        bool operator()(const record& a, const record& b) const noexcept { return a.key < b.key; }
+    };
+
+    template <class T>
+    bool same(const mystl::vector<T>& a, const mystl::vector<T>& b)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (!(a[i] == b[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 按键排序的结构体只比较键：mystl::sort 不稳定，键相同的元素顺序可以不同
+    bool same(const mystl::vector<record>& a, const mystl::vector<record>& b)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].key != b[i].key)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class T, class Less, class Radix, class RadixPar>
+    bool run(const char* name, const mystl::vector<T>& input, int reps, Less less, Radix radix, RadixPar radix_par)
+    {
+        mystl::vector<T> expect;
+        const double t_sort = bench::time_best(reps, [&]() { expect = input; }, [&]() {
+            mystl::sort(expect.begin(), expect.end(), less);
+        });
+        mystl::vector<T> v;
+        const double t_radix = bench::time_best(reps, [&]() { v = input; }, [&]() { radix(v); });
+        const bool ok = same(v, expect);
+        const double t_par = bench::time_best(reps, [&]() { v = input; }, [&]() { radix_par(v); });
+        const bool ok_par = same(v, expect);
+        std::printf("%-16s %10.4f %10.4f %8.2f %10.4f %8.2f %s\n", name, t_sort, t_radix, t_sort / t_radix,
+                    t_par, t_sort / t_par, ok && ok_par ? "ok" : "MISMATCH");
+        return ok && ok_par;
+    }
+
+    template <class T>
+    bool run_plain(const char* name, const mystl::vector<T>& input, int reps,
+                   const mystl::execution::parallel_policy& policy)
+    {
+        return run(name, input, reps, mystl::less_than(),
+                   [](mystl::vector<T>& v) { mystl::radix_sort(v.begin(), v.end()); },
+                   [&](mystl::vector<T>& v) { mystl::radix_sort(policy, v.begin(), v.end()); });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t n = bench::arg_size(argc, argv, 1, static_cast<size_t>(1) << 24);
+    size_t threads = bench::arg_size(argc, argv, 2, std::thread::hardware_concurrency());
+    const int reps = static_cast<int>(bench::arg_size(argc, argv, 3, 3));
+    threads = threads != 0 ? threads : 1;
+    const mystl::execution::parallel_policy policy = mystl::execution::par.with_threads(threads);
+
+    bench::rng rng(42);
+    mystl::vector<uint64_t> u64(n);
+    mystl::vector<uint64_t> small(n);
+    mystl::vector<uint32_t> u32(n);
+    mystl::vector<int64_t> i64(n);
+    mystl::vector<double> f64(n);
+    mystl::vector<record> rec(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint64_t x = rng();
+        u64[i] = x;
+        small[i] = x & ((static_cast<uint64_t>(1) << 20) - 1);
+        u32[i] = static_cast<uint32_t>(x >> 32);
+        i64[i] = static_cast<int64_t>(x);
+        f64[i] = static_cast<double>(x >> 11) / static_cast<double>(static_cast<uint64_t>(1) << 53) * 2e9 - 1e9;
+        rec[i].key = rng();
+        rec[i].payload = i;
+    }
+
+    std::printf("n = %zu, threads = %zu, hardware_concurrency = %u, best of %d\n",
+                n, threads, std::thread::hardware_concurrency(), reps);
+    std::printf("%-16s %10s %10s %8s %10s %8s %s\n",
+                "keys", "sort(s)", "radix(s)", "x", "par(s)", "x", "result");
+    bool ok = true;
+    ok = run_plain("uint64 random", u64, reps, policy) && ok;
+    ok = run_plain("uint64 < 2^20", small, reps, policy) && ok;
+    ok = run_plain("uint32 random", u32, reps, policy) && ok;
+    ok = run_plain("int64 random", i64, reps, policy) && ok;
+    ok = run_plain("double random", f64, reps, policy) && ok;
+    ok = run("record by key", rec, reps, record_less(),
+             [](mystl::vector<record>& v) { mystl::radix_sort(v.begin(), v.end(), record_key()); },
+             [&](mystl::vector<record>& v) { mystl::radix_sort(policy, v.begin(), v.end(), record_key()); }) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_BENCH_UTIL_H
+#define STL_BENCH_UTIL_H
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+
+// 这个头文件包含基准测试共用的计时、参数解析和防止编译器优化掉结果的工具
+// 每个 bench_*.cpp 是一个独立的可执行文件，运行时参数见各文件开头的注释，结果输出到 stdout
+
+namespace bench
+{
+    typedef std::chrono::steady_clock clock;
+
+    inline double seconds_since(clock::time_point start)
+    {
+        return std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    // 运行 reps 次，返回最短的一次（秒），每次之前调用 setup 准备输入，setup 不计时
+    template <class Setup, class Fn>
+    double time_best(int reps, Setup setup, Fn fn)
+    {
+        double best = 1e300;
+        for (int i = 0; i < reps; ++i)
+        {
+            setup();
+            const clock::time_point start = clock::now();
+            fn();
+            const double t = seconds_since(start);
+            best = t < best ? t : best;
+        }
+        return best;
+    }
+
+    template <class Fn>
+    double time_best(int reps, Fn fn)
+    {
+        return time_best(reps, []() {}, fn);
+    }
+
+    // 第 i 个命令行参数，没有时使用 def
+    inline size_t arg_size(int argc, char** argv, int i, size_t def)
+    {
+        return i < argc ? static_cast<size_t>(std::strtoull(argv[i], nullptr, 0)) : def;
+    }
+
+    // 让编译器认为 value 被读取过，不能把计算它的代码删掉
+    template <class T>
+    inline void do_not_optimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        volatile const char sink = *reinterpret_cast<const volatile char*>(&value);
+        (void)sink;
+#endif
+    }
+
+    // 简单的 xorshift 随机数，结果只由种子决定，各个基准测试之间可以复现
+    class rng
+    {
+    public:
+        explicit rng(unsigned long long seed) : state_(seed ? seed : 0x9e3779b97f4a7c15ULL) {}
+
+        unsigned long long operator()()
+        {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 7;
+            state_ ^= state_ << 17;
+            return state_;
+        }
+
+    private:
+        unsigned long long state_;
+    };
+}
+
+#endif //STL_BENCH_UTIL_H
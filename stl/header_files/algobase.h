@@ -9,6 +9,7 @@
 #pragma once
 
 #include "iterator.h"
+#include "utils.h"
 #include <iostream>
 #include <string.h>
 
@@ -88,7 +89,7 @@ namespace mystl
     void fill_cat(RandomIter first, RandomIter last, const T& value,
                   mystl::random_access_iterator_tag)
     {
-        fill_n(first, last - first, value);
+        mystl::fill_n(first, last - first, value);
     }
 
     template <class ForwardIter, class T>
@@ -7,6 +7,18 @@
 #pragma once
 #endif //STL_ALGORITHM_H
 
+#include "algobase.h"
+#include "iterator.h"
+#include "heap_algo.h"
+#include "simd_remove.h"
+#include "allocator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
 // 这个头文件包含了 mystl 的一系列算法
 
 namespace mystl {
@@ -14,7 +26,12 @@ namespace mystl {
     // bidirectional_iterator_tag类型的reverse
     template<class BidirectionalIter>
     void reverse_dispatch(BidirectionalIter first, BidirectionalIter second, bidirectional_iterator_tag) {
-        std::cout << "reverse_dispatch" << std::endl;
+        while (true) {
+            if (first == second || first == --second) {
+                return;
+            }
+            mystl::iter_swap(first++, second);
+        }
     }
 
     // random_access_iterator_tag类型的reverse
@@ -29,4 +46,553 @@ namespace mystl {
     void reverse(BidirectionalIter first, BidirectionalIter second) {
         mystl::reverse_dispatch(first, second, iterator_category(first));
     }
-}
\ No newline at end of file
+
+    /*****************************************************************************************/
+    // rotate
+    // 把 [first, middle) 和 [middle, last) 对调，返回原来的 *first 的新位置
+    // 三次翻转，只需要双向迭代器
+    /*****************************************************************************************/
+    template<class BidirectionalIter>
+    BidirectionalIter rotate(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last) {
+        if (first == middle) {
+            return last;
+        }
+        if (middle == last) {
+            return first;
+        }
+        mystl::reverse(first, middle);
+        mystl::reverse(middle, last);
+        // 第三次翻转整个区间，同时找出 first 的新位置
+        while (first != middle && middle != last) {
+            mystl::iter_swap(first++, --last);
+        }
+        if (first == middle) {
+            mystl::reverse(middle, last);
+            return last;
+        }
+        mystl::reverse(first, middle);
+        return first;
+    }
+
+    /*****************************************************************************************/
+    // remove_if
+    // 移除 [first, last) 中 pred 为真的元素，保留的元素按原来的顺序向前移动，一遍完成
+    // 返回新的尾部，[返回值, last) 中的元素处于有效但不确定的状态，容器需要再 erase 它们
+    /*****************************************************************************************/
+    template<class ForwardIter, class UnaryPredicate>
+    ForwardIter remove_if(ForwardIter first, ForwardIter last, UnaryPredicate pred) {
+        // 第一个要移除的元素之前的元素不需要移动
+        while (first != last && !pred(*first)) {
+            ++first;
+        }
+        if (first == last) {
+            return first;
+        }
+        ForwardIter result = first;
+        for (++first; first != last; ++first) {
+            if (!pred(*first)) {
+                *result = mystl::move(*first);
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    // 连续存储的算术类型：无分支的版本，每个元素都写出，写指针只在保留时前进，保留与否难以预测时避免分支预测失败
+    template<class T, class UnaryPredicate>
+    typename std::enable_if<std::is_arithmetic<T>::value, T *>::type
+    remove_if(T *first, T *last, UnaryPredicate pred) {
+        while (first != last && !pred(*first)) {
+            ++first;
+        }
+        if (first == last) {
+            return first;
+        }
+        T *result = first;
+        for (++first; first != last; ++first) {
+            const T x = *first;
+            *result = x;
+            result += !pred(x);
+        }
+        return result;
+    }
+
+    /*****************************************************************************************/
+    // remove
+    // 移除 [first, last) 中等于 value 的元素，返回新的尾部
+    // 4 字节或 8 字节的算术类型在连续存储上使用 simd_remove（见 simd_remove.h）
+    /*****************************************************************************************/
+    template<class ForwardIter, class T>
+    ForwardIter remove(ForwardIter first, ForwardIter last, const T &value) {
+        return mystl::remove_if(first, last, [&value](const typename iterator_traits<ForwardIter>::value_type &x) {
+            return x == value;
+        });
+    }
+
+    template<class T>
+    typename std::enable_if<mystl::simd_removable<T>::value, T *>::type
+    remove(T *first, T *last, const T &value) {
+        return mystl::simd_remove(first, last, value);
+    }
+
+    /*****************************************************************************************/
+    // remove_copy_if / remove_copy
+    // 把 [first, last) 中不需要移除的元素复制到以 result 为起始处的空间，返回复制结束的位置
+    /*****************************************************************************************/
+    template<class InputIter, class OutputIter, class UnaryPredicate>
+    OutputIter remove_copy_if(InputIter first, InputIter last, OutputIter result, UnaryPredicate pred) {
+        for (; first != last; ++first) {
+            if (!pred(*first)) {
+                *result = *first;
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    template<class InputIter, class OutputIter, class T>
+    OutputIter remove_copy(InputIter first, InputIter last, OutputIter result, const T &value) {
+        for (; first != last; ++first) {
+            if (!(*first == value)) {
+                *result = *first;
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    // 默认的比较，使用 operator<，排序、合并等算法没有传入 comp 时使用
+    struct less_than {
+        template<class T, class U>
+        bool operator()(const T &lhs, const U &rhs) const {
+            return lhs < rhs;
+        }
+    };
+
+    // 默认的相等判断，使用 operator==，unique 等算法没有传入 pred 时使用
+    struct equal_to {
+        template<class T, class U>
+        bool operator()(const T &lhs, const U &rhs) const {
+            return lhs == rhs;
+        }
+    };
+
+    /*****************************************************************************************/
+    // lower_bound / upper_bound
+    // 在有序区间 [first, last) 中二分查找第一个不小于 / 大于 value 的位置
+    /*****************************************************************************************/
+    template<class ForwardIter, class T, class Compared>
+    ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T &value, Compared comp) {
+        auto len = mystl::distance(first, last);
+        while (len > 0) {
+            auto half = len / 2;
+            ForwardIter middle = first;
+            mystl::advance(middle, half);
+            if (comp(*middle, value)) {
+                first = ++middle;
+                len = len - half - 1;
+            } else {
+                len = half;
+            }
+        }
+        return first;
+    }
+
+    template<class ForwardIter, class T>
+    ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T &value) {
+        return mystl::lower_bound(first, last, value, mystl::less_than());
+    }
+
+    template<class ForwardIter, class T, class Compared>
+    ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T &value, Compared comp) {
+        auto len = mystl::distance(first, last);
+        while (len > 0) {
+            auto half = len / 2;
+            ForwardIter middle = first;
+            mystl::advance(middle, half);
+            if (comp(value, *middle)) {
+                len = half;
+            } else {
+                first = ++middle;
+                len = len - half - 1;
+            }
+        }
+        return first;
+    }
+
+    template<class ForwardIter, class T>
+    ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T &value) {
+        return mystl::upper_bound(first, last, value, mystl::less_than());
+    }
+
+    /*****************************************************************************************/
+    // sort
+    // 内省排序（introsort）：三数取中的快速排序，递归深度超过 2 * log2(n) 时这一段改用堆排序，保证最坏 O(nlogn)，
+    // 分段不多于 kSortThreshold 个元素时停止划分，最后对整个区间做一次插入排序，此时每个元素离最终位置都很近
+    // 只接受随机访问迭代器（vector、deque、原生指针），不稳定
+    /*****************************************************************************************/
+    constexpr size_t kSortThreshold = 16;
+
+    // 找出 lg(n) 的整数部分，用于控制递归深度
+    template<class Size>
+    Size slg2(Size n) {
+        Size k = 0;
+        for (; n > 1; n >>= 1) {
+            ++k;
+        }
+        return k;
+    }
+
+    // 把 a、b、c 三者的中值交换到 result
+    template<class RandomIter, class Compared>
+    void move_median_to_first(RandomIter result, RandomIter a, RandomIter b, RandomIter c, Compared comp) {
+        if (comp(*a, *b)) {
+            if (comp(*b, *c)) {
+                mystl::iter_swap(result, b);
+            } else if (comp(*a, *c)) {
+                mystl::iter_swap(result, c);
+            } else {
+                mystl::iter_swap(result, a);
+            }
+        } else if (comp(*a, *c)) {
+            mystl::iter_swap(result, a);
+        } else if (comp(*b, *c)) {
+            mystl::iter_swap(result, c);
+        } else {
+            mystl::iter_swap(result, b);
+        }
+    }
+
+    // 以 *pivot 为枢轴划分 [first, last)，两端都有哨兵（pivot 不小于第一个、不大于某一个元素），不需要检查边界
+    template<class RandomIter, class Compared>
+    RandomIter unguarded_partition(RandomIter first, RandomIter last, RandomIter pivot, Compared comp) {
+        while (true) {
+            while (comp(*first, *pivot)) {
+                ++first;
+            }
+            --last;
+            while (comp(*pivot, *last)) {
+                --last;
+            }
+            if (!(first < last)) {
+                return first;
+            }
+            mystl::iter_swap(first, last);
+            ++first;
+        }
+    }
+
+    // 三数取中放到 first，再划分 [first + 1, last)
+    template<class RandomIter, class Compared>
+    RandomIter unguarded_partition_pivot(RandomIter first, RandomIter last, Compared comp) {
+        RandomIter mid = first + (last - first) / 2;
+        mystl::move_median_to_first(first, first + 1, mid, last - 1, comp);
+        return mystl::unguarded_partition(first + 1, last, first, comp);
+    }
+
+    template<class RandomIter, class Size, class Compared>
+    void intro_sort(RandomIter first, RandomIter last, Size depth_limit, Compared comp) {
+        while (static_cast<size_t>(last - first) > kSortThreshold) {
+            if (depth_limit == 0) {
+                // 划分得很不均匀，剩下的部分用堆排序
+                mystl::make_heap(first, last, comp);
+                mystl::sort_heap(first, last, comp);
+                return;
+            }
+            --depth_limit;
+            RandomIter cut = mystl::unguarded_partition_pivot(first, last, comp);
+            // 右半段递归，左半段循环
+            mystl::intro_sort(cut, last, depth_limit, comp);
+            last = cut;
+        }
+    }
+
+    // 前面一定有不大于 *last 的元素，不需要检查是否越过 first
+    template<class RandomIter, class Compared>
+    void unguarded_linear_insert(RandomIter last, Compared comp) {
+        auto value = mystl::move(*last);
+        RandomIter next = last;
+        --next;
+        while (comp(value, *next)) {
+            *last = mystl::move(*next);
+            last = next;
+            --next;
+        }
+        *last = mystl::move(value);
+    }
+
+    template<class RandomIter, class Compared>
+    void insertion_sort(RandomIter first, RandomIter last, Compared comp) {
+        if (first == last) {
+            return;
+        }
+        for (RandomIter i = first + 1; i != last; ++i) {
+            if (comp(*i, *first)) {
+                // 比第一个还小，整段后移
+                auto value = mystl::move(*i);
+                mystl::move_backward(first, i, i + 1);
+                *first = mystl::move(value);
+            } else {
+                mystl::unguarded_linear_insert(i, comp);
+            }
+        }
+    }
+
+    // intro_sort 之后每一段的最小值都在这一段中，前 kSortThreshold 个元素之后的插入不需要边界检查
+    template<class RandomIter, class Compared>
+    void final_insertion_sort(RandomIter first, RandomIter last, Compared comp) {
+        if (static_cast<size_t>(last - first) > kSortThreshold) {
+            mystl::insertion_sort(first, first + kSortThreshold, comp);
+            for (RandomIter i = first + kSortThreshold; i != last; ++i) {
+                mystl::unguarded_linear_insert(i, comp);
+            }
+        } else {
+            mystl::insertion_sort(first, last, comp);
+        }
+    }
+
+    template<class RandomIter, class Compared>
+    void sort(RandomIter first, RandomIter last, Compared comp) {
+        if (first != last) {
+            mystl::intro_sort(first, last, mystl::slg2(last - first) * 2, comp);
+            mystl::final_insertion_sort(first, last, comp);
+        }
+    }
+
+    template<class RandomIter>
+    void sort(RandomIter first, RandomIter last) {
+        mystl::sort(first, last, mystl::less_than());
+    }
+
+    /*****************************************************************************************/
+    // merge
+    // 把两个有序区间 [first1, last1)、[first2, last2) 合并到以 result 为起始处的空间，返回合并结束的位置
+    // 稳定：相等的元素中第一个区间的在前
+    /*****************************************************************************************/
+    template<class InputIter1, class InputIter2, class OutputIter, class Compared>
+    OutputIter merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                     OutputIter result, Compared comp) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first2, *first1)) {
+                *result = *first2;
+                ++first2;
+            } else {
+                *result = *first1;
+                ++first1;
+            }
+            ++result;
+        }
+        return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+    }
+
+    template<class InputIter1, class InputIter2, class OutputIter>
+    OutputIter merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, OutputIter result) {
+        return mystl::merge(first1, last1, first2, last2, result, mystl::less_than());
+    }
+
+    /*****************************************************************************************/
+    // temporary_buffer
+    // 向 mystl::allocator 申请最多 requested 个元素的未初始化内存，失败时减半重试，都失败时 size() 为 0
+    // 用于 inplace_merge、stable_sort，内存紧张时拿到多少用多少
+    /*****************************************************************************************/
+    template<class T>
+    class temporary_buffer {
+    private:
+        T *buffer_;
+        ptrdiff_t len_;
+
+    public:
+        explicit temporary_buffer(ptrdiff_t requested) noexcept: buffer_(nullptr), len_(0) {
+            const ptrdiff_t max_len = PTRDIFF_MAX / static_cast<ptrdiff_t>(sizeof(T));
+            ptrdiff_t len = requested < max_len ? requested : max_len;
+            for (; len > 0; len /= 2) {
+                try {
+                    buffer_ = mystl::allocator<T>::allocate(static_cast<size_t>(len));
+                    len_ = len;
+                    return;
+                } catch (...) {
+                    buffer_ = nullptr;
+                }
+            }
+        }
+
+        temporary_buffer(const temporary_buffer &) = delete;
+
+        temporary_buffer &operator=(const temporary_buffer &) = delete;
+
+        ~temporary_buffer() {
+            if (buffer_ != nullptr) {
+                mystl::allocator<T>::deallocate(buffer_, static_cast<size_t>(len_));
+            }
+        }
+
+        T *begin() const noexcept { return buffer_; }
+
+        ptrdiff_t size() const noexcept { return len_; }
+    };
+
+    /*****************************************************************************************/
+    // inplace_merge
+    // 把相邻的两个有序区间 [first, middle)、[middle, last) 合并为一个有序区间，稳定
+    // 缓冲区能放下较短的一段时，把它移到缓冲区再一遍合并回来，O(n)；
+    // 放不下时把较长的一段从中间切开，在另一段中二分找到对应的位置，旋转之后两边分别递归，
+    // 没有缓冲区时为 O(nlogn) 的原地合并；只需要双向迭代器，list 的区间也可以使用
+    /*****************************************************************************************/
+
+    // 缓冲区中的第一段和 [first2, last2) 从前向后合并到 result，第二段剩下的元素已经在最终的位置上
+    template<class T, class BidirectionalIter, class Compared>
+    void merge_forward_from_buffer(T *buf, T *buf_end, BidirectionalIter first2, BidirectionalIter last2,
+                                   BidirectionalIter result, Compared comp) {
+        while (buf != buf_end && first2 != last2) {
+            if (comp(*first2, *buf)) {
+                *result = mystl::move(*first2);
+                ++first2;
+            } else {
+                *result = mystl::move(*buf);
+                ++buf;
+            }
+            ++result;
+        }
+        mystl::move(buf, buf_end, result);
+    }
+
+    // [first1, last1) 和缓冲区中的第二段从后向前合并，写到 result 之前，第一段剩下的元素已经在最终的位置上
+    template<class BidirectionalIter, class T, class Compared>
+    void merge_backward_from_buffer(BidirectionalIter first1, BidirectionalIter last1, T *buf, T *buf_end,
+                                    BidirectionalIter result, Compared comp) {
+        if (buf == buf_end) {
+            return;
+        }
+        if (first1 == last1) {
+            mystl::move_backward(buf, buf_end, result);
+            return;
+        }
+        --last1;
+        --buf_end;
+        while (true) {
+            if (comp(*buf_end, *last1)) {
+                *--result = mystl::move(*last1);
+                if (first1 == last1) {
+                    mystl::move_backward(buf, ++buf_end, result);
+                    return;
+                }
+                --last1;
+            } else {
+                *--result = mystl::move(*buf_end);
+                if (buf == buf_end) {
+                    return;
+                }
+                --buf_end;
+            }
+        }
+    }
+
+    template<class BidirectionalIter, class Distance, class T, class Compared>
+    void merge_adaptive(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last,
+                        Distance len1, Distance len2, T *buf, Distance buf_size, Compared comp) {
+        if (len1 == 0 || len2 == 0) {
+            return;
+        }
+        if (len1 + len2 == 2) {
+            if (comp(*middle, *first)) {
+                mystl::iter_swap(first, middle);
+            }
+            return;
+        }
+        if (len1 <= len2 && len1 <= buf_size) {
+            T *buf_end = mystl::uninitialized_move(first, middle, buf);
+            try {
+                mystl::merge_forward_from_buffer(buf, buf_end, middle, last, first, comp);
+            } catch (...) {
+                mystl::destroy(buf, buf_end);
+                throw;
+            }
+            mystl::destroy(buf, buf_end);
+        } else if (len2 <= buf_size) {
+            T *buf_end = mystl::uninitialized_move(middle, last, buf);
+            try {
+                mystl::merge_backward_from_buffer(first, middle, buf, buf_end, last, comp);
+            } catch (...) {
+                mystl::destroy(buf, buf_end);
+                throw;
+            }
+            mystl::destroy(buf, buf_end);
+        } else {
+            BidirectionalIter cut1 = first;
+            BidirectionalIter cut2 = middle;
+            Distance len11 = 0;
+            Distance len22 = 0;
+            if (len1 > len2) {
+                len11 = len1 / 2;
+                mystl::advance(cut1, len11);
+                cut2 = mystl::lower_bound(middle, last, *cut1, comp);
+                len22 = mystl::distance(middle, cut2);
+            } else {
+                len22 = len2 / 2;
+                mystl::advance(cut2, len22);
+                cut1 = mystl::upper_bound(first, middle, *cut2, comp);
+                len11 = mystl::distance(first, cut1);
+            }
+            BidirectionalIter new_middle = mystl::rotate(cut1, middle, cut2);
+            mystl::merge_adaptive(first, cut1, new_middle, len11, len22, buf, buf_size, comp);
+            mystl::merge_adaptive(new_middle, cut2, last, len1 - len11, len2 - len22, buf, buf_size, comp);
+        }
+    }
+
+    template<class BidirectionalIter, class Compared>
+    void inplace_merge(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last, Compared comp) {
+        if (first == middle || middle == last) {
+            return;
+        }
+        typedef typename iterator_traits<BidirectionalIter>::value_type value_type;
+        typedef typename iterator_traits<BidirectionalIter>::difference_type Distance;
+        const Distance len1 = mystl::distance(first, middle);
+        const Distance len2 = mystl::distance(middle, last);
+        temporary_buffer<value_type> buf(len1 < len2 ? len1 : len2);
+        mystl::merge_adaptive(first, middle, last, len1, len2, buf.begin(), static_cast<Distance>(buf.size()), comp);
+    }
+
+    template<class BidirectionalIter>
+    void inplace_merge(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last) {
+        mystl::inplace_merge(first, middle, last, mystl::less_than());
+    }
+
+    /*****************************************************************************************/
+    // stable_sort
+    // 归并排序，不多于 kStableSortChunk 个元素的一段用插入排序，相邻两段已经有序时不再合并
+    // 申请能放下一半元素的缓冲区，拿到时 O(nlogn)，缓冲区越小合并越慢，没有缓冲区时 O(nlog^2n)
+    // 只接受随机访问迭代器（vector、deque、原生指针），list 使用成员函数 sort
+    /*****************************************************************************************/
+    constexpr size_t kStableSortChunk = 15;
+
+    template<class RandomIter, class Distance, class T, class Compared>
+    void stable_sort_adaptive(RandomIter first, RandomIter last, T *buf, Distance buf_size, Compared comp) {
+        const Distance len = last - first;
+        if (static_cast<size_t>(len) <= kStableSortChunk) {
+            mystl::insertion_sort(first, last, comp);
+            return;
+        }
+        RandomIter middle = first + len / 2;
+        mystl::stable_sort_adaptive(first, middle, buf, buf_size, comp);
+        mystl::stable_sort_adaptive(middle, last, buf, buf_size, comp);
+        if (comp(*middle, *(middle - 1))) {
+            mystl::merge_adaptive(first, middle, last, middle - first, last - middle, buf, buf_size, comp);
+        }
+    }
+
+    template<class RandomIter, class Compared>
+    void stable_sort(RandomIter first, RandomIter last, Compared comp) {
+        if (first == last) {
+            return;
+        }
+        typedef typename iterator_traits<RandomIter>::value_type value_type;
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        temporary_buffer<value_type> buf((last - first + 1) / 2);
+        mystl::stable_sort_adaptive(first, last, buf.begin(), static_cast<Distance>(buf.size()), comp);
+    }
+
+    template<class RandomIter>
+    void stable_sort(RandomIter first, RandomIter last) {
+        mystl::stable_sort(first, last, mystl::less_than());
+    }
+}
@@ -0,0 +1,124 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_ALIGNED_ALLOCATOR_H
+#define STL_ALIGNED_ALLOCATOR_H
+#pragma once
+
+#include <cstddef>
+
+#include "allocator.h"
+#include "construct.h"
+#include "utils.h"
+
+// 这个头文件包含模板类 aligned_allocator<T, Align>，分配的每一块内存都从 Align 对齐的地址开始，
+// 大小也上调到 Align 的倍数，这样两块内存不会落在同一个缓存行上
+// 用于单个容器的选择，比如每个线程一个 mystl::vector<int, mystl::cacheline_allocator<int>>，
+// 全局的选择见 allocator.h 中的 MYSTL_ALLOC_MIN_ALIGN
+
+#ifndef MYSTL_CACHELINE_SIZE
+#define MYSTL_CACHELINE_SIZE 64
+#endif
+
+namespace mystl
+{
+    template <class T, size_t Align = MYSTL_CACHELINE_SIZE>
+    class aligned_allocator
+    {
+        static_assert((Align & (Align - 1)) == 0, "Align must be a power of 2");
+
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        // rebind 保留对齐，list 的节点、deque 的 map 也按 Align 对齐
+        template <class U>
+        struct rebind
+        {
+            typedef aligned_allocator<U, Align> other;
+        };
+
+    private:
+        static constexpr size_t alloc_align = alignof(T) < Align ? Align : alignof(T);
+
+        static size_t alloc_bytes(size_type n) noexcept
+        {
+            return (n * sizeof(T) + alloc_align - 1) & ~(alloc_align - 1);
+        }
+
+    public:
+        aligned_allocator() noexcept = default;
+
+        template <class U>
+        aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+        static T* allocate()
+        {
+            return allocate(1);
+        }
+
+        static T* allocate(size_type n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            return static_cast<T*>(mystl::aligned_allocate(alloc_bytes(n), alloc_align));
+        }
+
+        static void deallocate(T* ptr)
+        {
+            deallocate(ptr, 1);
+        }
+
+        // n 必须和 allocate 时一致
+        static void deallocate(T* ptr, size_type n)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+            mystl::aligned_deallocate(ptr, alloc_bytes(n), alloc_align);
+        }
+
+        template <class... Args>
+        static void construct(T* ptr, Args&&... args)
+        {
+            mystl::construct(ptr, mystl::forward<Args>(args)...);
+        }
+
+        static void destroy(T* ptr)
+        {
+            mystl::destroy(ptr);
+        }
+
+        static void destroy(T* first, T* last)
+        {
+            mystl::destroy(first, last);
+        }
+    };
+
+    // 按缓存行对齐的分配器
+    template <class T>
+    using cacheline_allocator = aligned_allocator<T, MYSTL_CACHELINE_SIZE>;
+
+    template <class T, class U, size_t Align>
+    bool operator==(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U, size_t Align>
+    bool operator!=(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif //STL_ALIGNED_ALLOCATOR_H
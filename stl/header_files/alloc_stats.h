@@ -0,0 +1,291 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_ALLOC_STATS_H
+#define STL_ALLOC_STATS_H
+#pragma once
+
+// 这个头文件提供 allocator 的统计钩子，在编译期选择是否开启
+// 默认（没有定义 MYSTL_ALLOC_STATS）时，所有的宏都展开为空语句，allocate/deallocate 没有任何额外开销
+// 定义 MYSTL_ALLOC_STATS 之后，每个类型和全局各有一组计数器：分配/释放次数、存活字节数、累计字节数、峰值、
+// 按 2 的幂划分的大小类直方图，全部使用 relaxed 原子操作，可以用 alloc_stats_snapshot/alloc_stats_dump 读取，
+// 进程退出时如果还有存活的分配，会输出一份泄漏报告
+
+#include <cstddef>
+
+#ifdef MYSTL_ALLOC_STATS
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace mystl
+{
+    // 直方图的大小类：第 i 类是 (2^(i+3), 2^(i+4)] 字节，第 0 类包括 16 字节以下，最后一类包括更大的所有请求
+    enum { ALLOC_STATS_NCLASSES = 20 };
+
+    inline size_t alloc_stats_class(size_t bytes) noexcept
+    {
+        size_t c = 0;
+        size_t limit = 16;
+        while (bytes > limit && c + 1 < static_cast<size_t>(ALLOC_STATS_NCLASSES))
+        {
+            limit <<= 1;
+            ++c;
+        }
+        return c;
+    }
+
+    // 某一时刻计数器的拷贝
+    struct alloc_stats_data
+    {
+        const char* name;
+        size_t      alloc_count;   // 累计分配次数
+        size_t      free_count;    // 累计释放次数
+        size_t      live_bytes;    // 当前存活的字节数
+        size_t      total_bytes;   // 累计分配的字节数
+        size_t      peak_bytes;    // 存活字节数的峰值
+        size_t      histogram[ALLOC_STATS_NCLASSES];
+
+        size_t live_count() const noexcept { return alloc_count - free_count; }
+    };
+
+    /*****************************************************************************************/
+    // alloc_counters
+    // 一组计数器，每个类型一组，另有一组全局的，所有的组串成一个单链表用于 dump
+    /*****************************************************************************************/
+    class alloc_counters
+    {
+    public:
+        explicit alloc_counters(const char* name) noexcept
+                : name_(name), alloc_count_(0), free_count_(0), live_bytes_(0), total_bytes_(0),
+                  peak_bytes_(0), next_(nullptr)
+        {
+            for (auto& h : histogram_)
+            {
+                h.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void record_alloc(size_t bytes) noexcept
+        {
+            alloc_count_.fetch_add(1, std::memory_order_relaxed);
+            total_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+            histogram_[alloc_stats_class(bytes)].fetch_add(1, std::memory_order_relaxed);
+            const size_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            size_t peak = peak_bytes_.load(std::memory_order_relaxed);
+            while (live > peak &&
+                   !peak_bytes_.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void record_free(size_t bytes) noexcept
+        {
+            free_count_.fetch_add(1, std::memory_order_relaxed);
+            live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        // 各个计数器分别读取，不是一个原子的整体，但每一项都是准确的
+        alloc_stats_data snapshot() const noexcept
+        {
+            alloc_stats_data d;
+            d.name = name_;
+            d.alloc_count = alloc_count_.load(std::memory_order_relaxed);
+            d.free_count = free_count_.load(std::memory_order_relaxed);
+            d.live_bytes = live_bytes_.load(std::memory_order_relaxed);
+            d.total_bytes = total_bytes_.load(std::memory_order_relaxed);
+            d.peak_bytes = peak_bytes_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < static_cast<size_t>(ALLOC_STATS_NCLASSES); ++i)
+            {
+                d.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+            }
+            return d;
+        }
+
+        const alloc_counters* next() const noexcept { return next_; }
+
+        void set_next(alloc_counters* next) noexcept { next_ = next; }
+
+    private:
+        const char*          name_;
+        std::atomic<size_t>  alloc_count_;
+        std::atomic<size_t>  free_count_;
+        std::atomic<size_t>  live_bytes_;
+        std::atomic<size_t>  total_bytes_;
+        std::atomic<size_t>  peak_bytes_;
+        std::atomic<size_t>  histogram_[ALLOC_STATS_NCLASSES];
+        alloc_counters*      next_;
+    };
+
+    // 所有类型计数器组成的链表头
+    inline std::atomic<alloc_counters*>& alloc_counters_list() noexcept
+    {
+        static std::atomic<alloc_counters*> head{nullptr};
+        return head;
+    }
+
+    inline void alloc_stats_dump(FILE* out = stderr);
+
+    inline void alloc_stats_leak_report();
+
+    // 全局计数器，第一次使用时注册退出时的泄漏报告
+    // 计数器故意不释放，这样退出过程中析构的静态容器仍然可以记录
+    inline alloc_counters& alloc_stats_global() noexcept
+    {
+        static alloc_counters* global = []() {
+            auto g = new alloc_counters("<global>");
+            std::atexit(alloc_stats_leak_report);
+            return g;
+        }();
+        return *global;
+    }
+
+    // 包含这个头文件的每个翻译单元都有一个 alloc_stats_init，它在这个翻译单元中之后定义的静态容器之前构造，
+    // 退出报告因此先于这些容器注册，在它们析构之后才运行（和 <iostream> 的 ios_base::Init 相同的做法）；
+    // 否则默认构造时不分配的全局容器析构得比报告晚，会被误报为泄漏
+    struct alloc_stats_init
+    {
+        alloc_stats_init() noexcept { alloc_stats_global(); }
+    };
+
+    namespace
+    {
+        const alloc_stats_init alloc_stats_init_instance;
+    }
+
+    // 从 __PRETTY_FUNCTION__ 中取出类型名，不支持时为空
+    template <class T>
+    const char* alloc_stats_type_name() noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __PRETTY_FUNCTION__;
+#else
+        return "";
+#endif
+    }
+
+    // 类型 T 的计数器，第一次使用时用 CAS 挂到链表上
+    template <class T>
+    alloc_counters& alloc_stats_of() noexcept
+    {
+        static alloc_counters* c = []() {
+            auto p = new alloc_counters(alloc_stats_type_name<T>());
+            auto& list = alloc_counters_list();
+            auto old_head = list.load(std::memory_order_relaxed);
+            do
+            {
+                p->set_next(old_head);
+            } while (!list.compare_exchange_weak(old_head, p,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
+            return p;
+        }();
+        return *c;
+    }
+
+    template <class T>
+    void alloc_stats_record_alloc(size_t bytes) noexcept
+    {
+        alloc_stats_global().record_alloc(bytes);
+        alloc_stats_of<T>().record_alloc(bytes);
+    }
+
+    template <class T>
+    void alloc_stats_record_free(size_t bytes) noexcept
+    {
+        alloc_stats_global().record_free(bytes);
+        alloc_stats_of<T>().record_free(bytes);
+    }
+
+    // 全局计数器的快照
+    inline alloc_stats_data alloc_stats_snapshot() noexcept
+    {
+        return alloc_stats_global().snapshot();
+    }
+
+    // 类型 T 的计数器的快照
+    template <class T>
+    alloc_stats_data alloc_stats_snapshot() noexcept
+    {
+        return alloc_stats_of<T>().snapshot();
+    }
+
+    // 输出一组计数器，name 只输出 "T = " 之后的类型名部分
+    inline void alloc_stats_print(const alloc_stats_data& d, FILE* out)
+    {
+        const char* name = d.name;
+        size_t len = std::strlen(name);
+        const char* with = std::strstr(name, "T = ");
+        if (with != nullptr)
+        {
+            name = with + 4;
+            len = std::strcspn(name, ";]");
+        }
+        std::fprintf(out, "%.*s: allocs=%zu frees=%zu live=%zu live_bytes=%zu total_bytes=%zu peak_bytes=%zu\n",
+                     static_cast<int>(len), name, d.alloc_count, d.free_count, d.live_count(),
+                     d.live_bytes, d.total_bytes, d.peak_bytes);
+        size_t limit = 16;
+        for (size_t i = 0; i < static_cast<size_t>(ALLOC_STATS_NCLASSES); ++i, limit <<= 1)
+        {
+            if (d.histogram[i] != 0)
+            {
+                if (i + 1 == static_cast<size_t>(ALLOC_STATS_NCLASSES))
+                {
+                    std::fprintf(out, "    >%-9zu %zu\n", limit >> 1, d.histogram[i]);
+                }
+                else
+                {
+                    std::fprintf(out, "    <=%-8zu %zu\n", limit, d.histogram[i]);
+                }
+            }
+        }
+    }
+
+    // 输出全局和每个类型的计数器
+    inline void alloc_stats_dump(FILE* out)
+    {
+        alloc_stats_print(alloc_stats_global().snapshot(), out);
+        for (const alloc_counters* c = alloc_counters_list().load(std::memory_order_acquire);
+             c != nullptr; c = c->next())
+        {
+            alloc_stats_print(c->snapshot(), out);
+        }
+    }
+
+    // 进程退出时调用，只输出仍有存活分配的类型
+    inline void alloc_stats_leak_report()
+    {
+        const alloc_stats_data g = alloc_stats_global().snapshot();
+        if (g.live_count() == 0)
+        {
+            return;
+        }
+        std::fprintf(stderr, "mystl: %zu allocations (%zu bytes) still live at exit\n",
+                     g.live_count(), g.live_bytes);
+        for (const alloc_counters* c = alloc_counters_list().load(std::memory_order_acquire);
+             c != nullptr; c = c->next())
+        {
+            const alloc_stats_data d = c->snapshot();
+            if (d.live_count() != 0)
+            {
+                alloc_stats_print(d, stderr);
+            }
+        }
+    }
+}
+
+// 记录一次类型 T 的分配/释放，bytes 为字节数
+#define MYSTL_ALLOC_STATS_ALLOC(T, bytes) mystl::alloc_stats_record_alloc<T>(bytes)
+#define MYSTL_ALLOC_STATS_FREE(T, bytes)  mystl::alloc_stats_record_free<T>(bytes)
+
+#else
+
+#define MYSTL_ALLOC_STATS_ALLOC(T, bytes) ((void)0)
+#define MYSTL_ALLOC_STATS_FREE(T, bytes)  ((void)0)
+
+#endif // MYSTL_ALLOC_STATS
+
+#endif //STL_ALLOC_STATS_H
@@ -8,14 +8,110 @@
 #endif //STL_ALLOCATOR_H
 #pragma once
 #include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include "alloc_stats.h"
 #include "construct.h"
+#include "type_traits.h"
 
 
 // 这个头文件包含一个模板类 allocator，用于管理内存的分配、释放，对象的构造、析构
+// 以及 allocator_traits 和 alloc_holder，容器通过它们支持自定义的（可以有状态的）分配器
+
+// ::operator new 默认能保证的对齐，对齐要求更高的类型需要走对齐的分配
+#ifdef __STDCPP_DEFAULT_NEW_ALIGNMENT__
+#define MYSTL_DEFAULT_NEW_ALIGN __STDCPP_DEFAULT_NEW_ALIGNMENT__
+#else
+#define MYSTL_DEFAULT_NEW_ALIGN alignof(std::max_align_t)
+#endif
+
+// allocator 分配的每一块内存起始地址的最小对齐，必须是 2 的幂
+// 定义为 64 可以让 vector 的存储、deque 的缓冲区、list 的节点都从缓存行开始，避免不同线程的容器伪共享
+#ifndef MYSTL_ALLOC_MIN_ALIGN
+#define MYSTL_ALLOC_MIN_ALIGN 1
+#endif
 
 
 namespace mystl
 {
+    static_assert((MYSTL_ALLOC_MIN_ALIGN & (MYSTL_ALLOC_MIN_ALIGN - 1)) == 0,
+                  "MYSTL_ALLOC_MIN_ALIGN must be a power of 2");
+
+    // 分配 bytes 字节，起始地址按 align 对齐
+    // 不超过默认对齐时直接使用 ::operator new，否则使用对齐的 operator new（C++17），
+    // 没有对齐的 operator new 时多申请 align + sizeof(void*) 字节，在对齐后的地址之前保存原始指针
+    inline void* aligned_allocate(size_t bytes, size_t align)
+    {
+        if (align <= MYSTL_DEFAULT_NEW_ALIGN)
+        {
+            return ::operator new(bytes);
+        }
+#ifdef __cpp_aligned_new
+        return ::operator new(bytes, std::align_val_t(align));
+#else
+        void* raw = ::operator new(bytes + align + sizeof(void*));
+        const uintptr_t p = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + align - 1)
+                            & ~(static_cast<uintptr_t>(align) - 1);
+        reinterpret_cast<void**>(p)[-1] = raw;
+        return reinterpret_cast<void*>(p);
+#endif
+    }
+
+    // 释放 aligned_allocate 分配的内存，bytes 和 align 必须和分配时一致，有 sized delete 时使用它
+    inline void aligned_deallocate(void* ptr, size_t bytes, size_t align) noexcept
+    {
+        if (align <= MYSTL_DEFAULT_NEW_ALIGN)
+        {
+#ifdef __cpp_sized_deallocation
+            ::operator delete(ptr, bytes);
+#else
+            (void)bytes;
+            ::operator delete(ptr);
+#endif
+            return;
+        }
+#ifdef __cpp_aligned_new
+#ifdef __cpp_sized_deallocation
+        ::operator delete(ptr, bytes, std::align_val_t(align));
+#else
+        (void)bytes;
+        ::operator delete(ptr, std::align_val_t(align));
+#endif
+#else
+        (void)bytes;
+        ::operator delete(static_cast<void**>(ptr)[-1]);
+#endif
+    }
+
+    // malloc 对 bytes 字节的请求实际给出的可用大小，多出的部分原本只是浪费在 chunk 的尾部
+    // glibc：chunk 16 字节对齐、带 8 字节头部，最小 24 字节可用，超过 mmap 阈值（128 KiB）的请求按页映射，
+    // 其它平台不知道分配器的大小类，原样返回
+    inline size_t malloc_good_size(size_t bytes) noexcept
+    {
+#if defined(__GLIBC__)
+        if (bytes >= 128 * 1024)
+        {
+            const size_t page = 4096;
+            const size_t rounded = (bytes + 16 + page - 1) & ~(page - 1);
+            return rounded < bytes ? bytes : rounded - 16;
+        }
+        const size_t rounded = ((bytes + 8 + 15) & ~static_cast<size_t>(15)) - 8;
+        return rounded < 24 ? 24 : rounded;
+#else
+        return bytes;
+#endif
+    }
+
+    // allocate_at_least 的返回值：起始地址和实际得到的元素个数，count 不小于请求的个数
+    // 释放时可以传入 [请求的个数, count] 中的任意值
+    template <class Pointer>
+    struct allocation_result
+    {
+        Pointer ptr;
+        size_t  count;
+    };
+
     template <class T>
     class allocator
     {
@@ -28,28 +124,49 @@ namespace mystl
         typedef size_t size_type;
         typedef ptrdiff_t difference_type;
 
+        // 把 allocator<T> 转换为 allocator<U>，list 用它得到节点的分配器，deque 用它得到 map 的分配器
+        template <class U>
+        struct rebind
+        {
+            typedef allocator<U> other;
+        };
+
     public:
+        allocator() noexcept = default;
+
+        template <class U>
+        allocator(const allocator<U>&) noexcept {}
+
         static T* allocate(); // 分配一个T类型的内存   只调用operator new分配内存，没有调用构造函数
         static T* allocate(size_type n); // 分配n个T类型的
 
+        // 分配至少n个T类型的，把请求上调到 malloc 实际给出的大小，多出的空间也能放元素
+        static allocation_result<T*> allocate_at_least(size_type n);
+
         static void deallocate(T* ptr); // 销毁  只调用operator delete销毁内存，没有调用析构函数
-        static void deallocate(T* ptr, size_type n); // 销毁n个，但实现方式和上面一样
+        static void deallocate(T* ptr, size_type n); // 销毁n个，n 必须和 allocate 时一致（sized delete）
 
         static void construct(T* ptr); // 构造函数 ,在ptr所指的地方调用placement new来构造
         static void construct(T* ptr, const T& value);
         static void construct(T* ptr, T&& value);
 
+        template <class... Args>
+        static void construct(T* ptr, Args&&... args);
+
         static void destroy(T* ptr);  // 会调用析构函数
         static void destroy(T* first, T* last);
 
-
-
+    private:
+        // 分配的对齐：alignof(T) 和 MYSTL_ALLOC_MIN_ALIGN 中较大的一个
+        static constexpr size_t alloc_align =
+                alignof(T) < MYSTL_ALLOC_MIN_ALIGN ? MYSTL_ALLOC_MIN_ALIGN : alignof(T);
     };
 
     template <class T>
     T* allocator<T>::allocate()
     {
-        return static_cast<T*>(::operator new(sizeof(T)));
+        MYSTL_ALLOC_STATS_ALLOC(T, sizeof(T));
+        return static_cast<T*>(mystl::aligned_allocate(sizeof(T), alloc_align));
     }
 
     template <class T>
@@ -59,8 +176,29 @@ namespace mystl
         {
             return nullptr;
         }
-        return static_cast<T*>(::operator new(n * sizeof(T)));
+        MYSTL_ALLOC_STATS_ALLOC(T, n * sizeof(T));
+        return static_cast<T*>(mystl::aligned_allocate(n * sizeof(T), alloc_align));
+    }
 
+    // 直接按上调之后的大小申请，释放时 sized delete 的大小和申请时一致
+    // 不使用 malloc_usable_size 事后查询，因为那样释放的大小和 ::operator new 收到的大小不一致
+    template <class T>
+    allocation_result<T*> allocator<T>::allocate_at_least(size_type n)
+    {
+        if (n == 0)
+        {
+            return {nullptr, 0};
+        }
+        size_type count = n;
+        if (alloc_align <= MYSTL_DEFAULT_NEW_ALIGN && n <= static_cast<size_type>(-1) / sizeof(T) / 2)
+        {
+            count = mystl::malloc_good_size(n * sizeof(T)) / sizeof(T);
+            if (count < n)
+            {
+                count = n;
+            }
+        }
+        return {allocate(count), count};
     }
 
     template <class T>
@@ -70,7 +208,8 @@ namespace mystl
         {
             return;
         }
-        ::operator delete(ptr);
+        MYSTL_ALLOC_STATS_FREE(T, sizeof(T));
+        mystl::aligned_deallocate(ptr, sizeof(T), alloc_align);
     }
 
     template <class T>
@@ -80,7 +219,8 @@ namespace mystl
         {
             return;
         }
-        ::operator delete(ptr);
+        MYSTL_ALLOC_STATS_FREE(T, n * sizeof(T));
+        mystl::aligned_deallocate(ptr, n * sizeof(T), alloc_align);
     }
 
     template <class T>
@@ -101,6 +241,13 @@ namespace mystl
         mystl::construct(ptr, mystl::move(value));
     }
 
+    template <class T>
+    template <class... Args>
+    void allocator<T>::construct(T* ptr, Args&&... args)
+    {
+        mystl::construct(ptr, mystl::forward<Args>(args)...);
+    }
+
     template <class T>
     void allocator<T>::destroy(T* ptr)
     {
@@ -113,5 +260,203 @@ namespace mystl
         mystl::destroy(first, last);
     }
 
+    // allocator 没有状态，任意两个实例都可以释放对方分配的内存
+    template <class T, class U>
+    bool operator==(const allocator<T>&, const allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const allocator<T>&, const allocator<U>&) noexcept
+    {
+        return false;
+    }
+
+    /*****************************************************************************************/
+    // allocator_traits
+    // 萃取分配器的 rebind 和拷贝、移动、交换时的传播规则，分配器没有定义的项使用默认值
+    /*****************************************************************************************/
+
+    template <class... Ts>
+    struct alloc_void
+    {
+        typedef void type;
+    };
+
+    template <class Alloc, class U, class = void>
+    struct alloc_has_rebind : public m_false_type {};
+
+    template <class Alloc, class U>
+    struct alloc_has_rebind<Alloc, U, typename alloc_void<typename Alloc::template rebind<U>::other>::type>
+            : public m_true_type {};
+
+    // 分配器定义了 rebind 时使用它，否则把 Alloc<T, Args...> 转换为 Alloc<U, Args...>
+    template <class Alloc, class U, bool = alloc_has_rebind<Alloc, U>::value>
+    struct alloc_rebind
+    {
+        typedef typename Alloc::template rebind<U>::other type;
+    };
+
+    template <template <class, class...> class Alloc, class T, class... Args, class U>
+    struct alloc_rebind<Alloc<T, Args...>, U, false>
+    {
+        typedef Alloc<U, Args...> type;
+    };
+
+    // 以下萃取传播规则，分配器中没有对应的 typedef 时为 m_false_type
+#define MYSTL_ALLOC_TRAIT_DETECT(NAME, DEFAULT)                                          \
+    template <class Alloc, class = void>                                                 \
+    struct alloc_##NAME : public DEFAULT {};                                             \
+    template <class Alloc>                                                               \
+    struct alloc_##NAME<Alloc, typename alloc_void<typename Alloc::NAME>::type>          \
+            : public m_bool_constant<Alloc::NAME::value> {};
+
+    MYSTL_ALLOC_TRAIT_DETECT(propagate_on_container_copy_assignment, m_false_type)
+    MYSTL_ALLOC_TRAIT_DETECT(propagate_on_container_move_assignment, m_false_type)
+    MYSTL_ALLOC_TRAIT_DETECT(propagate_on_container_swap, m_false_type)
+    MYSTL_ALLOC_TRAIT_DETECT(is_always_equal, m_bool_constant<std::is_empty<Alloc>::value>)
+    // deallocate 是否什么都不做（比如 arena），为真时容器可以跳过逐个释放
+    MYSTL_ALLOC_TRAIT_DETECT(deallocate_is_noop, m_false_type)
+
+#undef MYSTL_ALLOC_TRAIT_DETECT
+
+    // 分配器定义了 select_on_container_copy_construction 时调用它，否则直接拷贝
+    template <class Alloc>
+    auto alloc_select_on_copy(const Alloc& a, int)
+    -> decltype(a.select_on_container_copy_construction())
+    {
+        return a.select_on_container_copy_construction();
+    }
+
+    template <class Alloc>
+    Alloc alloc_select_on_copy(const Alloc& a, long)
+    {
+        return a;
+    }
+
+    // 分配器定义了 reallocate(p, old_n, new_n)（原地扩展，可能移动地址但不逐个搬移元素）时调用它，否则返回 nullptr
+    template <class Alloc>
+    auto alloc_reallocate(Alloc& a, typename Alloc::pointer p, size_t old_n, size_t new_n, int)
+    -> decltype(a.reallocate(p, old_n, new_n))
+    {
+        return a.reallocate(p, old_n, new_n);
+    }
+
+    template <class Alloc>
+    typename Alloc::pointer alloc_reallocate(Alloc&, typename Alloc::pointer, size_t, size_t, long)
+    {
+        return nullptr;
+    }
+
+    // 分配器定义了 allocate_at_least(n) 时调用它，否则就是 allocate(n)，得到的个数正好是 n
+    template <class Alloc>
+    auto alloc_allocate_at_least(Alloc& a, size_t n, int)
+    -> decltype(a.allocate_at_least(n))
+    {
+        return a.allocate_at_least(n);
+    }
+
+    template <class Alloc>
+    allocation_result<typename Alloc::pointer> alloc_allocate_at_least(Alloc& a, size_t n, long)
+    {
+        return {a.allocate(n), n};
+    }
+
+    template <class Alloc, class = void>
+    struct alloc_has_reallocate : public m_false_type {};
+
+    template <class Alloc>
+    struct alloc_has_reallocate<Alloc, typename alloc_void<decltype(std::declval<Alloc&>().reallocate(
+            std::declval<typename Alloc::pointer>(), size_t(), size_t()))>::type>
+            : public m_true_type {};
+
+    template <class Alloc>
+    struct allocator_traits
+    {
+        typedef Alloc                              allocator_type;
+        typedef typename Alloc::value_type         value_type;
+        typedef typename Alloc::pointer            pointer;
+        typedef typename Alloc::size_type          size_type;
+        typedef typename Alloc::difference_type    difference_type;
+
+        template <class U>
+        using rebind_alloc = typename alloc_rebind<Alloc, U>::type;
+
+        typedef alloc_propagate_on_container_copy_assignment<Alloc> propagate_on_container_copy_assignment;
+        typedef alloc_propagate_on_container_move_assignment<Alloc> propagate_on_container_move_assignment;
+        typedef alloc_propagate_on_container_swap<Alloc>            propagate_on_container_swap;
+        typedef alloc_is_always_equal<Alloc>                        is_always_equal;
+        typedef alloc_deallocate_is_noop<Alloc>                     deallocate_is_noop;
+
+        // 元素可以平凡析构，且 deallocate 什么都不做时，销毁容器不需要做任何事情
+        static constexpr bool can_skip_destroy =
+                std::is_trivially_destructible<value_type>::value && deallocate_is_noop::value;
+
+        typedef alloc_has_reallocate<Alloc>                         has_reallocate;
+
+        // 把 p 开始的 old_n 个元素的内存扩展为 new_n 个，内容按位保留，原来的 p 失效
+        // 分配器不支持或者这一次不能扩展时返回 nullptr，这时 p 仍然有效
+        static pointer reallocate(Alloc& a, pointer p, size_type old_n, size_type new_n)
+        {
+            return mystl::alloc_reallocate(a, p, old_n, new_n, 0);
+        }
+
+        // 分配至少 n 个元素，count 为实际的个数，容器用它作为容量，释放时传入 count
+        static allocation_result<pointer> allocate_at_least(Alloc& a, size_type n)
+        {
+            return mystl::alloc_allocate_at_least(a, n, 0);
+        }
+
+        // 拷贝构造容器时，新容器使用的分配器
+        static Alloc select_on_container_copy_construction(const Alloc& a)
+        {
+            return mystl::alloc_select_on_copy(a, 0);
+        }
+
+        // 两个分配器能否互相释放对方分配的内存
+        static bool equal(const Alloc& lhs, const Alloc& rhs) noexcept
+        {
+            return is_always_equal::value || lhs == rhs;
+        }
+    };
+
+    /*****************************************************************************************/
+    // alloc_holder
+    // 容器通过继承它来保存分配器实例，空的分配器利用空基类优化不占用空间，有状态的分配器作为成员保存
+    /*****************************************************************************************/
+    template <class Alloc, bool = std::is_empty<Alloc>::value && !std::is_final<Alloc>::value>
+    class alloc_holder : private Alloc
+    {
+    public:
+        alloc_holder() = default;
+
+        explicit alloc_holder(const Alloc& a) noexcept : Alloc(a) {}
+
+        explicit alloc_holder(Alloc&& a) noexcept : Alloc(mystl::move(a)) {}
+
+        Alloc& get_alloc() noexcept { return *this; }
+
+        const Alloc& get_alloc() const noexcept { return *this; }
+    };
+
+    template <class Alloc>
+    class alloc_holder<Alloc, false>
+    {
+    public:
+        alloc_holder() = default;
+
+        explicit alloc_holder(const Alloc& a) noexcept : alloc_(a) {}
+
+        explicit alloc_holder(Alloc&& a) noexcept : alloc_(mystl::move(a)) {}
+
+        Alloc& get_alloc() noexcept { return alloc_; }
+
+        const Alloc& get_alloc() const noexcept { return alloc_; }
+
+    private:
+        Alloc alloc_;
+    };
+
 }
 
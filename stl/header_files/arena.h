@@ -0,0 +1,214 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_ARENA_H
+#define STL_ARENA_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "allocator.h"
+#include "construct.h"
+#include "utils.h"
+
+// 这个头文件包含单调增长的内存区 monotonic_arena 和适配器 arena_allocator
+// arena 从大块内存中移动指针来分配，deallocate 什么都不做，arena 析构（或 release）时一次性释放所有的块
+// 适合生命周期相同的一批容器，比如一次请求中创建的所有 vector、list，请求结束时整体释放
+// monotonic_arena 不是线程安全的，每个线程（每个请求）应该使用自己的 arena
+
+namespace mystl
+{
+    /*****************************************************************************************/
+    // monotonic_arena
+    /*****************************************************************************************/
+    class monotonic_arena
+    {
+    public:
+        enum { ARENA_DEFAULT_BLOCK = 64 * 1024 };     // 第一块的默认大小
+        enum { ARENA_MAX_BLOCK = 16 * 1024 * 1024 };  // 块大小翻倍增长的上限
+
+    private:
+        // 每一块的头部，所有的块串成一个单链表，块的数据紧跟在头部之后
+        struct block_header
+        {
+            block_header* next;
+            size_t        size;  // 整块的字节数，包括头部
+        };
+
+        static constexpr size_t header_size =
+                (sizeof(block_header) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+        block_header* blocks_;       // 最新的一块
+        char*         cur_;          // 当前块中下一次分配的位置
+        char*         end_;          // 当前块的结尾
+        size_t        next_size_;    // 下一块的大小
+        size_t        allocated_;    // 已经分配出去的字节数
+
+    public:
+        explicit monotonic_arena(size_t initial_block = ARENA_DEFAULT_BLOCK) noexcept
+                : blocks_(nullptr), cur_(nullptr), end_(nullptr),
+                  next_size_(initial_block < header_size * 2 ? header_size * 2 : initial_block),
+                  allocated_(0) {}
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+        ~monotonic_arena()
+        {
+            release();
+        }
+
+        // 分配 bytes 字节，起始地址按 align 对齐
+        void* allocate(size_t bytes, size_t align = alignof(std::max_align_t))
+        {
+            char* p = align_up(cur_, align);
+            if (cur_ == nullptr || p + bytes > end_)
+            {
+                new_block(bytes + align);
+                p = align_up(cur_, align);
+            }
+            cur_ = p + bytes;
+            allocated_ += bytes;
+            return p;
+        }
+
+        // 单调分配，单个对象的释放什么都不做
+        void deallocate(void*, size_t) noexcept {}
+
+        // 一次性释放所有的块
+        void release() noexcept
+        {
+            while (blocks_ != nullptr)
+            {
+                block_header* next = blocks_->next;
+                ::operator delete(blocks_);
+                blocks_ = next;
+            }
+            cur_ = end_ = nullptr;
+            allocated_ = 0;
+        }
+
+        // 已经分配出去的字节数（不包括对齐和块尾部浪费的空间）
+        size_t bytes_allocated() const noexcept { return allocated_; }
+
+    private:
+        static char* align_up(char* p, size_t align) noexcept
+        {
+            const auto v = reinterpret_cast<uintptr_t>(p);
+            return reinterpret_cast<char*>((v + align - 1) & ~(static_cast<uintptr_t>(align) - 1));
+        }
+
+        // 申请一块至少能容纳 min_bytes 的新块，块的大小翻倍增长
+        void new_block(size_t min_bytes)
+        {
+            size_t size = next_size_;
+            if (size < min_bytes + header_size)
+            {
+                size = min_bytes + header_size;
+            }
+            auto block = static_cast<block_header*>(::operator new(size));
+            block->next = blocks_;
+            block->size = size;
+            blocks_ = block;
+            cur_ = reinterpret_cast<char*>(block) + header_size;
+            end_ = reinterpret_cast<char*>(block) + size;
+            if (next_size_ < static_cast<size_t>(ARENA_MAX_BLOCK))
+            {
+                next_size_ *= 2;
+            }
+        }
+    };
+
+    /*****************************************************************************************/
+    // arena_allocator
+    // 把 monotonic_arena 包装成 allocator 的接口，可以用于 vector、list、deque
+    // 保存的是 arena 的指针，拷贝、rebind 之后仍然指向同一个 arena
+    /*****************************************************************************************/
+    template <class T>
+    class arena_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        // deallocate 什么都不做，容器在元素可以平凡析构时会跳过整个析构、释放的过程
+        typedef m_true_type deallocate_is_noop;
+
+        template <class U>
+        struct rebind
+        {
+            typedef arena_allocator<U> other;
+        };
+
+        template <class U>
+        friend class arena_allocator;
+
+    private:
+        monotonic_arena* arena_;
+
+    public:
+        explicit arena_allocator(monotonic_arena& arena) noexcept : arena_(&arena) {}
+
+        template <class U>
+        arena_allocator(const arena_allocator<U>& rhs) noexcept : arena_(rhs.arena_) {}
+
+        monotonic_arena* arena() const noexcept { return arena_; }
+
+        T* allocate()
+        {
+            return allocate(1);
+        }
+
+        T* allocate(size_type n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*) noexcept {}
+
+        void deallocate(T*, size_type) noexcept {}
+
+        template <class... Args>
+        void construct(T* ptr, Args&&... args)
+        {
+            mystl::construct(ptr, mystl::forward<Args>(args)...);
+        }
+
+        void destroy(T* ptr)
+        {
+            mystl::destroy(ptr);
+        }
+
+        void destroy(T* first, T* last)
+        {
+            mystl::destroy(first, last);
+        }
+    };
+
+    // 指向同一个 arena 的分配器才相等
+    template <class T, class U>
+    bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+    {
+        return lhs.arena() == rhs.arena();
+    }
+
+    template <class T, class U>
+    bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif //STL_ARENA_H
@@ -8,7 +8,10 @@
 #endif //STL_CONSTRUCT_H
 #pragma once
 #include <new>
+#include <iterator>
+#include <type_traits>
 #include "utils.h"
+#include "trace.h"
 
 namespace mystl {
 
@@ -35,20 +38,26 @@ namespace mystl {
     // destroy 将对象析构
 
     template <class Ty>
-    void destroy_one(Ty*, std::true_type) {
-        std::cout << "void destroy_one(Ty*, std::true_type)" << std::endl;
-    }
+    void destroy_one(Ty*, std::true_type) {}
 
     template <class Ty>
     void destroy_one(Ty* pointer, std::false_type)
     {
-        std::cout << "void destroy_one(Ty* pointer, std::false_type)" << std::endl;
         if (pointer != nullptr)
         {
             pointer->~Ty();
         }
     }
 
+    template <class Ty>
+    void destroy(Ty* pointer)
+    {
+        MYSTL_TRACE_EVENT("destroy", pointer, 1);
+        // std::is_trivially_destructible 测试类型是否为完全无法易损坏。
+        destroy_one(pointer, std::is_trivially_destructible<Ty>{});
+    }
+
+    // destroy_cat 必须在 destroy(Ty*) 之后定义，否则模板实例化时找不到它
     template <class ForwardIter>
     void destroy_cat(ForwardIter, ForwardIter, std::true_type) {}
 
@@ -56,16 +65,7 @@ namespace mystl {
     void destroy_cat(ForwardIter first, ForwardIter last, std::false_type)
     {
         for (; first != last; ++first)
-            destroy(&*first);
-    }
-
-
-    template <class Ty>
-    void destroy(Ty* pointer)
-    {
-        std::cout << "void destroy(Ty* pointer)" << std::endl;
-        // std::is_trivially_destructible 测试类型是否为完全无法易损坏。
-        destroy_one(pointer, std::is_trivially_destructible<Ty>{});
+            mystl::destroy(&*first);
     }
 
     template <class ForwardIter>
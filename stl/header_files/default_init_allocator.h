@@ -0,0 +1,66 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_DEFAULT_INIT_ALLOCATOR_H
+#define STL_DEFAULT_INIT_ALLOCATOR_H
+#pragma once
+
+#include <new>
+
+#include "allocator.h"
+#include "construct.h"
+
+// 这个头文件包含分配器适配器 default_init_allocator<T, Alloc>
+// 内存的分配、释放都交给 Alloc，只是没有参数的 construct(p) 改为默认初始化（new (p) T），不再值初始化（new (p) T()）
+// 对 int、char 这类平凡的类型，vector(n)、resize(n) 新增的元素不会被清零，省掉一次完整的内存写入，
+// 适合马上就会被 read()、解码覆盖的缓冲区；有默认构造函数的类型和原来一样调用它
+// 例如：mystl::vector<char, mystl::default_init_allocator<char>> buf(64 << 20);
+
+namespace mystl
+{
+    template <class T, class Alloc = mystl::allocator<T>>
+    class default_init_allocator : public Alloc
+    {
+        typedef mystl::allocator_traits<Alloc> base_traits;
+
+    public:
+        // rebind 之后仍然是 default_init_allocator，被适配的分配器也跟着 rebind
+        template <class U>
+        struct rebind
+        {
+            typedef default_init_allocator<U, typename base_traits::template rebind_alloc<U>> other;
+        };
+
+        default_init_allocator() = default;
+
+        default_init_allocator(const Alloc& alloc) noexcept : Alloc(alloc) {}
+
+        template <class U, class UAlloc>
+        default_init_allocator(const default_init_allocator<U, UAlloc>& rhs) noexcept
+                : Alloc(static_cast<const UAlloc&>(rhs)) {}
+
+        // 有参数的 construct 交给 Alloc
+        using Alloc::construct;
+
+        // 默认初始化，隐藏 Alloc 中的 construct(T*)
+        void construct(T* ptr)
+        {
+            ::new (static_cast<void*>(ptr)) T;
+        }
+    };
+
+    template <class T, class AllocT, class U, class AllocU>
+    bool operator==(const default_init_allocator<T, AllocT>& lhs, const default_init_allocator<U, AllocU>& rhs)
+    {
+        return static_cast<const AllocT&>(lhs) == static_cast<const AllocU&>(rhs);
+    }
+
+    template <class T, class AllocT, class U, class AllocU>
+    bool operator!=(const default_init_allocator<T, AllocT>& lhs, const default_init_allocator<U, AllocU>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif //STL_DEFAULT_INIT_ALLOCATOR_H
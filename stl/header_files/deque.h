@@ -6,6 +6,11 @@
 #include "allocator.h"
 #include "algobase.h"
 #include "uninitialized.h"
+#include "trace.h"
+#include "hardening.h"
+#include "span.h"
+
+#include <stdexcept>
 
 #pragma once
 #ifndef STL_DEQUE_H
@@ -51,13 +56,40 @@ namespace mystl {
         value_pointer last;  // 指向缓冲区的尾部
         map_pointer node; // 缓冲区的所在的节点
 
+#if MYSTL_HARDENING_LEVEL >= 2
+        // begin()/end() 返回的迭代器记录 deque 的代数，deque 内部保存的 begin_/end_ 不记录（gen_src 为空）
+        const size_t *gen_src = nullptr;
+        size_t gen = 0;
+
+        void attach(const size_t *src) noexcept {
+            gen_src = src;
+            gen = *src;
+        }
 
+        void check_valid() const {
+            MYSTL_ITERATOR_ASSERT(gen_src == nullptr || *gen_src == gen, "use of an invalidated deque iterator");
+        }
+#else
+        void check_valid() const noexcept {}
+#endif
 
         // 构造、复制、移动函数
         deque_iterator() noexcept: cur(nullptr), first(nullptr), last(nullptr), node(nullptr) {
 
         }
 
+        deque_iterator(value_pointer v, map_pointer n)
+                : cur(v), first(*n), last(*n + buffer_size), node(n) {}
+
+        // 对 iterator 来说是拷贝构造，对 const_iterator 来说是从 iterator 的转换
+        deque_iterator(const iterator &rhs)
+                : cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node) {
+#if MYSTL_HARDENING_LEVEL >= 2
+            gen_src = rhs.gen_src;
+            gen = rhs.gen;
+#endif
+        }
+
 
         // 将new_node指向的缓冲区复制到本身
         void set_node(map_pointer new_node) {
@@ -69,22 +101,38 @@ namespace mystl {
 
         // 操作符重载
         self &operator=(const iterator &rhs) {
-            if (this != &rhs) {
-                cur = rhs.cur;
-                first = rhs.first;
-                last = rhs.last;
-                node = rhs.node;
-            }
+            cur = rhs.cur;
+            first = rhs.first;
+            last = rhs.last;
+            node = rhs.node;
+#if MYSTL_HARDENING_LEVEL >= 2
+            gen_src = rhs.gen_src;
+            gen = rhs.gen;
+#endif
             return *this;
         }
 
+        bool operator==(const self &rhs) const { return cur == rhs.cur; }
+
+        bool operator!=(const self &rhs) const { return !(*this == rhs); }
+
+        bool operator<(const self &rhs) const {
+            return node == rhs.node ? (cur < rhs.cur) : (node < rhs.node);
+        }
+
+        bool operator>(const self &rhs) const { return rhs < *this; }
+
         bool operator<=(const self &rhs) const { return !(rhs < *this); }
 
+        bool operator>=(const self &rhs) const { return !(*this < rhs); }
+
         reference operator*() const {
+            check_valid();
             return *cur;
         }
 
         pointer operator->() const {
+            check_valid();
             return cur;
         }
 
@@ -102,8 +150,20 @@ namespace mystl {
             return *this += -n;
         }
 
+        self operator+(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp += n;
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
         self& operator+=(difference_type n)
         {
+            check_valid();
             const auto offset = n + (cur - first);
             if (offset >= 0 && offset < static_cast<difference_type>(buffer_size))
             { // 仍在当前缓冲区
@@ -121,6 +181,7 @@ namespace mystl {
         }
         // 前++
         self &operator++() {
+            check_valid();
             ++cur;
             // 到缓冲区结尾，需要跳到下一个缓冲区
             if (cur == last) {
@@ -139,6 +200,7 @@ namespace mystl {
         }
 
         self &operator--() {
+            check_valid();
             if (cur == first) {
                 set_node(node - 1);
                 cur = last;
@@ -158,23 +220,105 @@ namespace mystl {
 
     };
 
-    // deque 实现
-    template<class T>
-    class deque {
+    // deque 的分段视图，[first, last) 中每个缓冲区里的那一段元素作为一个连续的 span，
+    // 可以不经拷贝交给只接受连续内存的 I/O、SIMD 函数，例如：
+    // for (auto seg : d.segments()) { write(fd, seg.data(), seg.size_bytes()); }
+    // 迭代器的解引用按值返回 span，插入元素之后视图失效
+    template<class T, class Ref, class Ptr>
+    struct deque_segment_iterator
+            : public iterator<forward_iterator_tag, span<typename std::remove_pointer<Ptr>::type>,
+                    ptrdiff_t, void, span<typename std::remove_pointer<Ptr>::type>> {
+        typedef typename std::remove_pointer<Ptr>::type element_type;
+        typedef span<element_type> value_type;
+        typedef value_type reference;
+        typedef T **map_pointer;
+        typedef deque_segment_iterator self;
+
+        static const size_t buffer_size = deque_buf_size<T>::value;
+
+        element_type *cur;       // 当前这一段的起点
+        map_pointer node;        // 当前这一段所在的缓冲区
+        element_type *end_cur;   // 整个区间的终点
+        map_pointer end_node;
+
+        deque_segment_iterator() noexcept: cur(nullptr), node(nullptr), end_cur(nullptr), end_node(nullptr) {}
+
+        deque_segment_iterator(element_type *c, map_pointer n, element_type *ec, map_pointer en) noexcept
+                : cur(c), node(n), end_cur(ec), end_node(en) {}
+
+        // 最后一个缓冲区到 end_cur 为止，其它的到缓冲区尾部为止
+        reference operator*() const {
+            return node == end_node ? value_type(cur, end_cur) : value_type(cur, *node + buffer_size);
+        }
+
+        self &operator++() {
+            if (node == end_node) {
+                cur = end_cur;
+            } else {
+                ++node;
+                cur = *node;
+            }
+            return *this;
+        }
+
+        self operator++(int) {
+            self temp = *this;
+            ++*this;
+            return temp;
+        }
 
+        // 每个位置的 cur 都不相同，last 恰好在缓冲区开头时，最后一个缓冲区是空段，直接等于终点
+        bool operator==(const self &rhs) const { return cur == rhs.cur; }
+
+        bool operator!=(const self &rhs) const { return cur != rhs.cur; }
+    };
+
+    template<class T, class Ref, class Ptr>
+    class deque_segment_range {
     public:
-        typedef mystl::allocator<T> allocator_type;
-        typedef mystl::allocator<T> data_allocator;
+        typedef deque_segment_iterator<T, Ref, Ptr> iterator;
+        typedef deque_iterator<T, Ref, Ptr> deque_iter;
+
+        deque_segment_range(const deque_iter &first, const deque_iter &last) noexcept
+                : begin_(first.cur, first.node, last.cur, last.node),
+                  end_(last.cur, last.node, last.cur, last.node) {}
+
+        iterator begin() const noexcept { return begin_; }
+
+        iterator end() const noexcept { return end_; }
+
+        bool empty() const noexcept { return begin_ == end_; }
+
+    private:
+        iterator begin_;
+        iterator end_;
+    };
+
+    // [first, last) 按缓冲区划分的视图
+    template<class T, class Ref, class Ptr>
+    deque_segment_range<T, Ref, Ptr> segments(const deque_iterator<T, Ref, Ptr> &first,
+                                               const deque_iterator<T, Ref, Ptr> &last) noexcept {
+        return deque_segment_range<T, Ref, Ptr>(first, last);
+    }
+
+    // deque 实现，保存的是元素的分配器，map 的分配器需要时由它 rebind 得到
+    template<class T, class Alloc = mystl::allocator<T>>
+    class deque : private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>> {
+
+    public:
+        typedef Alloc allocator_type;
+        typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> data_allocator;
         // 注意里面放的T*
-        typedef mystl::allocator<T *> map_allocator;
+        typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T *> map_allocator;
+        typedef mystl::allocator_traits<data_allocator> alloc_traits;
 
-        typedef typename allocator_type::value_type value_type;
-        typedef typename allocator_type::pointer pointer;
-        typedef typename allocator_type::const_pointer const_pointer;
-        typedef typename allocator_type::reference reference;
-        typedef typename allocator_type::const_reference const_reference;
-        typedef typename allocator_type::size_type size_type;
-        typedef typename allocator_type::difference_type difference_type;
+        typedef typename data_allocator::value_type value_type;
+        typedef typename data_allocator::pointer pointer;
+        typedef typename data_allocator::const_pointer const_pointer;
+        typedef typename data_allocator::reference reference;
+        typedef typename data_allocator::const_reference const_reference;
+        typedef typename data_allocator::size_type size_type;
+        typedef typename data_allocator::difference_type difference_type;
 
         // map_pointer 其实就是指向一个指针，这个指针指向的是数据T
         typedef pointer *map_pointer;
@@ -184,34 +328,110 @@ namespace mystl {
         typedef deque_iterator<T, const T &, const T *> const_iterator;
         typedef mystl::reverse_iterator<iterator> reverse_iterator;
         typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef deque_segment_range<T, T &, T *> segment_range;
+        typedef deque_segment_range<T, const T &, const T *> const_segment_range;
 
 
         // deque 中一个buf的大小
         static const size_type buffer_size = deque_buf_size<T>::value;
 
     private:
+        typedef mystl::alloc_holder<data_allocator> alloc_base;
+
+        data_allocator &data_alloc() noexcept { return this->get_alloc(); }
+
+        const data_allocator &data_alloc() const noexcept { return this->get_alloc(); }
+
+        map_allocator map_alloc() const noexcept { return map_allocator(data_alloc()); }
+
         // deque 中的数据成员
         iterator begin_;             // 指向第一个节点
         iterator end_;               // 指向最后一个节点
         map_pointer map_;            // 指向一块map，map中都是指针，指向一块缓冲区
         size_type map_size_;         // map中的指针的数目
 
+#if MYSTL_HARDENING_LEVEL >= 2
+        size_t generation_ = 0;      // 迭代器的代数，push_front/push_back、交换让它加一
+
+        void invalidate_iterators() noexcept { ++generation_; }
+
+        iterator attached(iterator it) noexcept {
+            it.attach(&generation_);
+            return it;
+        }
+
+        const_iterator attached(const_iterator it) const noexcept {
+            it.attach(&generation_);
+            return it;
+        }
+#else
+        void invalidate_iterators() noexcept {}
+
+        iterator attached(iterator it) noexcept { return it; }
+
+        const_iterator attached(const_iterator it) const noexcept { return it; }
+#endif
+
     public:
 
         // 构造等一系列函数
 
-        deque() {
-            fill_init(0, value_type());
-        }
+        // 空的 deque 不分配 map 和缓冲区，第一次插入时才分配
+        deque() noexcept: map_(nullptr), map_size_(0) {}
+
+        // 使用指定的分配器实例
+        explicit deque(const allocator_type &alloc) noexcept
+                : alloc_base(data_allocator(alloc)), map_(nullptr), map_size_(0) {}
 
-        explicit deque(size_type n) {
+        explicit deque(size_type n, const allocator_type &alloc = allocator_type())
+                : alloc_base(data_allocator(alloc)) {
             fill_init(n, value_type());
         }
 
-        deque(size_type n, const value_type &value) {
+        deque(size_type n, const value_type &value, const allocator_type &alloc = allocator_type())
+                : alloc_base(data_allocator(alloc)) {
             fill_init(n, value);
         }
 
+        // 拷贝构造，分配器由 select_on_container_copy_construction 决定
+        deque(const deque &rhs)
+                : alloc_base(alloc_traits::select_on_container_copy_construction(rhs.data_alloc())) {
+            map_init(rhs.size());
+            mystl::uninitialized_copy(rhs.begin(), rhs.end(), begin_);
+        }
+
+        deque(const deque &rhs, const allocator_type &alloc) : alloc_base(data_allocator(alloc)) {
+            map_init(rhs.size());
+            mystl::uninitialized_copy(rhs.begin(), rhs.end(), begin_);
+        }
+
+        // 移动构造，分配器随数据一起移动过来，rhs变为没有map的空状态
+        deque(deque &&rhs) noexcept
+                : alloc_base(mystl::move(rhs.data_alloc())), begin_(rhs.begin_), end_(rhs.end_),
+                  map_(rhs.map_), map_size_(rhs.map_size_) {
+            rhs.begin_ = iterator();
+            rhs.end_ = iterator();
+            rhs.map_ = nullptr;
+            rhs.map_size_ = 0;
+        }
+
+        deque &operator=(const deque &rhs);
+
+        // 移动赋值，分配器不传播并且可能不相等时需要分配内存，不是 noexcept
+        deque &operator=(deque &&rhs) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                               alloc_traits::is_always_equal::value);
+
+        ~deque() {
+            release();
+        }
+
+        allocator_type get_allocator() const {
+            return allocator_type(data_alloc());
+        }
+
+        // swap 将自己和rhs交换，propagate_on_container_swap 为真时连同分配器一起交换
+        void swap(deque &rhs) noexcept;
+
 
         bool empty() const noexcept {
             return begin() == end();
@@ -225,35 +445,76 @@ namespace mystl {
 
         // 访问元素相关操作
         reference operator[](size_type n) {
+            MYSTL_HARDENING_ASSERT(n < size(), "deque::operator[] index out of range");
+            return begin_[n];
+        }
+
+        const_reference operator[](size_type n) const {
+            MYSTL_HARDENING_ASSERT(n < size(), "deque::operator[] index out of range");
             return begin_[n];
         }
 
-        // 其实就是调用[]
+        // at 越界时抛出 std::out_of_range
         reference at(size_type n) {
-            return (*(this))[n];
+            if (n >= size()) {
+                throw std::out_of_range("deque<T>::at() subscript out of range");
+            }
+            return begin_[n];
+        }
+
+        const_reference at(size_type n) const {
+            if (n >= size()) {
+                throw std::out_of_range("deque<T>::at() subscript out of range");
+            }
+            return begin_[n];
         }
 
         reference front() {
-            return *begin();
+            MYSTL_HARDENING_ASSERT(!empty(), "deque::front() on empty deque");
+            return *begin_;
+        }
+
+        const_reference front() const {
+            MYSTL_HARDENING_ASSERT(!empty(), "deque::front() on empty deque");
+            return *begin_;
         }
 
         reference back() {
+            MYSTL_HARDENING_ASSERT(!empty(), "deque::back() on empty deque");
             // 记住-1
-            return *(end() - 1);
+            return *(end_ - 1);
+        }
+
+        const_reference back() const {
+            MYSTL_HARDENING_ASSERT(!empty(), "deque::back() on empty deque");
+            return *(end_ - 1);
         }
 
     public:
         // 迭代器相关操作
         iterator begin() noexcept {
-            return begin_;
+            return attached(begin_);
+        }
+
+        const_iterator begin() const noexcept {
+            return attached(begin_);
         }
 
         iterator end() noexcept {
-            return end_;
+            return attached(end_);
         }
 
         const_iterator         end()     const noexcept
-        { return end_; }
+        { return attached(end_); }
+
+        // 按缓冲区划分的视图，每一段是一个 span，见 deque_segment_range
+        segment_range segments() noexcept {
+            return segment_range(begin_, end_);
+        }
+
+        const_segment_range segments() const noexcept {
+            return const_segment_range(begin_, end_);
+        }
 
         // 在头部插入
         void push_front(const value_type &value);
@@ -268,15 +529,31 @@ namespace mystl {
         void pop_back();
 
     private:
+        struct no_init_tag {};
+
+        // 只分配可以容纳n个元素的map和缓冲区，不构造元素，由调用者负责构造[begin_, end_)
+        deque(size_type n, const allocator_type &alloc, no_init_tag) : alloc_base(data_allocator(alloc)) {
+            map_init(n);
+        }
+
+        // 交换数据和分配器，用于赋值操作中和临时对象交换
+        void swap_all(deque &rhs) noexcept;
+
+        // 析构所有元素，释放所有缓冲区和map
+        void release();
+
         // deque常见辅助函数
-        // 初始化map
+        // 初始化可以容纳 nelem 个元素的map和缓冲区，nelem 为 0 时什么都不分配（map_ 为空）
         void map_init(size_type nelem);
 
+        // 分配map和缓冲区，map_init 和第一次插入时使用
+        void create_map_and_buffer(size_type nelem);
+
         // 初始化deque里面的数据
         void fill_init(size_type n, const value_type &value);
 
-        // 创建一块map,但没有初始化值
-        map_pointer create_map(size_type size);
+        // 创建一块至少有 size 个指针的map，指针都为空，size 改为分配器实际给出的个数
+        map_pointer create_map(size_type &size);
 
         // 创建map中 nstart到nfinish中每一个指针所指向的buffer
         void create_buffer(map_pointer nstart, map_pointer nfinish);
@@ -284,29 +561,138 @@ namespace mystl {
         // 需要重新创建n个空间
         void require_capacity(size_type n, bool front);
 
+        // map 的一侧不够 need_buffer 个空位时调用，把使用中的指针移到（必要时更大的）map 的中央
+        void reallocate_map(size_type need_buffer, bool front);
+
         // 删除[nstart,nfinish]之间的buffer
         void destroy_buffer(map_pointer nstart, map_pointer nfinish);
 
+        // 移动赋值时分配器不相等，只能用自己的分配器逐个移动元素
+        // 单独成为一个函数：分配器总是相等时这里不会被调用，rethrow 不会出现在 noexcept 的 operator= 中
+        void move_assign_unequal(deque &rhs);
+
     };
 
 
 //    --------------------------------------------------------------------------------------------------
 
 
-    template<class T>
-    void deque<T>::push_front(const value_type &value) {
+    template<class T, class Alloc>
+    deque<T, Alloc> &deque<T, Alloc>::operator=(const deque &rhs) {
+        if (this != &rhs) {
+            // propagate_on_container_copy_assignment 为真时使用rhs的分配器，否则保留自己的
+            const allocator_type alloc = alloc_traits::propagate_on_container_copy_assignment::value
+                                         ? rhs.get_allocator() : get_allocator();
+            deque temp(rhs, alloc);
+            swap_all(temp);
+        }
+        return *this;
+    }
+
+    template<class T, class Alloc>
+    deque<T, Alloc> &deque<T, Alloc>::operator=(deque &&rhs)
+    noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+        if (this != &rhs) {
+            if (alloc_traits::propagate_on_container_move_assignment::value ||
+                alloc_traits::equal(data_alloc(), rhs.data_alloc())) {
+                // 可以直接接管rhs的内存，原来的数据交给temp析构
+                deque temp(mystl::move(rhs));
+                swap_all(temp);
+                if (!alloc_traits::propagate_on_container_move_assignment::value) {
+                    mystl::swap(data_alloc(), temp.data_alloc());
+                }
+            } else {
+                move_assign_unequal(rhs);
+            }
+        }
+        return *this;
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::move_assign_unequal(deque &rhs) {
+        deque temp(rhs.size(), get_allocator(), no_init_tag());
+        try {
+            mystl::uninitialized_move(rhs.begin_, rhs.end_, temp.begin_);
+        } catch (...) {
+            // 已经构造的元素由 uninitialized_move 析构，让 temp 变为空，只留下第一个缓冲区由析构函数释放
+            temp.destroy_buffer(temp.begin_.node + 1, temp.end_.node);
+            temp.end_ = temp.begin_;
+            throw;
+        }
+        swap_all(temp);
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::swap(deque &rhs) noexcept {
+        if (this != &rhs) {
+            mystl::swap(begin_, rhs.begin_);
+            mystl::swap(end_, rhs.end_);
+            mystl::swap(map_, rhs.map_);
+            mystl::swap(map_size_, rhs.map_size_);
+            invalidate_iterators();
+            rhs.invalidate_iterators();
+            if (alloc_traits::propagate_on_container_swap::value) {
+                mystl::swap(data_alloc(), rhs.data_alloc());
+            }
+        }
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::swap_all(deque &rhs) noexcept {
+        mystl::swap(begin_, rhs.begin_);
+        mystl::swap(end_, rhs.end_);
+        mystl::swap(map_, rhs.map_);
+        mystl::swap(map_size_, rhs.map_size_);
+        mystl::swap(data_alloc(), rhs.data_alloc());
+        invalidate_iterators();
+        rhs.invalidate_iterators();
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::release() {
+        if (map_ == nullptr) {
+            return;
+        }
+        if (alloc_traits::can_skip_destroy) {
+            // 缓冲区和map都由 arena 之类的分配器统一回收
+            map_ = nullptr;
+            map_size_ = 0;
+            return;
+        }
+        // 按缓冲区析构元素，每一段都是连续的指针区间
+        if (begin_.node == end_.node) {
+            data_alloc().destroy(begin_.cur, end_.cur);
+        } else {
+            data_alloc().destroy(begin_.cur, begin_.last);
+            for (map_pointer cur = begin_.node + 1; cur < end_.node; ++cur) {
+                data_alloc().destroy(*cur, *cur + buffer_size);
+            }
+            data_alloc().destroy(end_.first, end_.cur);
+        }
+        destroy_buffer(begin_.node, end_.node);
+        map_alloc().deallocate(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::push_front(const value_type &value) {
+        invalidate_iterators();
+        if (map_ == nullptr) {
+            create_map_and_buffer(0);
+        }
 
         if (begin_.cur != begin_.first) {
             // cur不是第一个，则可以直接插入
-            data_allocator::construct(begin_.cur - 1, value);
+            data_alloc().construct(begin_.cur - 1, value);
             --begin_.cur;
         } else {
             // 是第一个，所以要重新创建buffer
-            std::cout << "push_front" << std::endl;
+            MYSTL_TRACE_EVENT("deque::push_front require_capacity", this, size());
             require_capacity(1, true);
             try {
                 --begin_;
-                data_allocator::construct(begin_.cur, value);
+                data_alloc().construct(begin_.cur, value);
 
             } catch (...) {
                 ++begin_;
@@ -316,54 +702,56 @@ namespace mystl {
 
     }
 
-    template<class T>
-    void deque<T>::pop_back() {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::pop_back() {
+        MYSTL_HARDENING_ASSERT(!empty(), "deque::pop_back() on empty deque");
         if (end_.cur != end_.first) {
             // 不是最后一个buffer的first
             --end_.cur;
-            data_allocator::destroy(end_.cur);
+            data_alloc().destroy(end_.cur);
         } else {
             // 是最后一个buffer的第一个元素，所以先--end_
             --end_;
-            data_allocator::destroy(end_.cur);
+            data_alloc().destroy(end_.cur);
             destroy_buffer(end_.node + 1, end_.node + 1);
         }
     }
 
-    template<class T>
-    void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::destroy_buffer(map_pointer nstart, map_pointer nfinish) {
         for (map_pointer m = nstart; m <= nfinish; m++) {
-            data_allocator::deallocate(*m, buffer_size);
+            data_alloc().deallocate(*m, buffer_size);
             *m = nullptr;
         }
 
     }
 
-    template<class T>
-    void deque<T>::pop_front() {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::pop_front() {
+        MYSTL_HARDENING_ASSERT(!empty(), "deque::pop_front() on empty deque");
         if (begin_.cur != begin_.last - 1) {
             // cur没有到结尾,直接弹出
-            data_allocator::destroy(begin_.cur);
+            data_alloc().destroy(begin_.cur);
             ++begin_.cur;
         } else {
-            data_allocator::destroy(begin_.cur);
-            ++begin_.cur;
-            // 由于是此时第一个buffer为空
+            data_alloc().destroy(begin_.cur);
+            // 跳到下一个buffer，此时原来的第一个buffer为空
+            ++begin_;
             destroy_buffer(begin_.node - 1, begin_.node - 1);
         }
 
     }
 
 
-    template<class T>
-    void deque<T>::require_capacity(size_type n, bool front) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::require_capacity(size_type n, bool front) {
 
         if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n)) {
             // 在最前面添加,此时begin_.cur = begin_.first
             const size_type need_buffer = (n - (begin_.cur - begin_.first)) / buffer_size + 1;
             if (need_buffer > static_cast<size_type>(begin_.node - map_)) {
                 // 重新分配map的大小
-                return;
+                reallocate_map(need_buffer, true);
             }
             create_buffer(begin_.node - need_buffer, begin_.node - 1);
 
@@ -374,40 +762,72 @@ namespace mystl {
 
             if (need_buffer > static_cast<size_type>((map_ + map_size_) - end_.node - 1)) {
                 // 相当于目前创建的map的大小已经不能提供新的指针指向缓冲区，所以要重新分配map的大小
-                return;
+                reallocate_map(need_buffer, false);
             }
             create_buffer(end_.node + 1, end_.node + need_buffer);
 
         }
     }
 
-    template<class T>
-    void deque<T>::push_back(const value_type &value) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::reallocate_map(size_type need_buffer, bool front) {
+        const size_type old_nodes = static_cast<size_type>(end_.node - begin_.node) + 1;
+        const size_type new_nodes = old_nodes + need_buffer;
+        map_pointer new_start;
+        if (map_size_ > 2 * new_nodes) {
+            // map 还有一半以上是空的，只是空位都在另一侧，把使用中的指针移回中央即可
+            new_start = map_ + (map_size_ - new_nodes) / 2 + (front ? need_buffer : 0);
+            if (new_start < begin_.node) {
+                mystl::copy(begin_.node, end_.node + 1, new_start);
+            } else {
+                mystl::copy_backward(begin_.node, end_.node + 1, new_start + old_nodes);
+            }
+        } else {
+            size_type new_map_size = map_size_ + mystl::max(map_size_, need_buffer) + 2;
+            map_pointer new_map = create_map(new_map_size);
+            new_start = new_map + (new_map_size - new_nodes) / 2 + (front ? need_buffer : 0);
+            mystl::copy(begin_.node, end_.node + 1, new_start);
+            map_alloc().deallocate(map_, map_size_);
+            map_ = new_map;
+            map_size_ = new_map_size;
+        }
+        // 缓冲区没有变化，迭代器只需要换到新的节点上
+        begin_.node = new_start;
+        end_.node = new_start + old_nodes - 1;
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::push_back(const value_type &value) {
+        invalidate_iterators();
+        if (map_ == nullptr) {
+            create_map_and_buffer(0);
+        }
         // 还有位置，直接添加
         if (end_.cur != end_.last - 1) {
-            data_allocator::construct(end_.cur, value);
+            data_alloc().construct(end_.cur, value);
             ++end_.cur;
         } else {
             // 需要重新申请空间
             // 需要1个，且在最后添加
+            MYSTL_TRACE_EVENT("deque::push_back require_capacity", this, size());
             require_capacity(1, false);
-            data_allocator::construct(end_.cur, value);
+            data_alloc().construct(end_.cur, value);
             ++end_;
         }
     }
 
-    template<class T>
-    void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::create_buffer(map_pointer nstart, map_pointer nfinish) {
         map_pointer cur;
         try {
 
             for (cur = nstart; cur <= nfinish; ++cur) {
-                *cur = data_allocator::allocate(buffer_size);
+                *cur = data_alloc().allocate(buffer_size);
             }
         } catch (...) {
             while (cur != nstart) {
                 --cur;
-                data_allocator::deallocate(*cur, buffer_size);
+                data_alloc().deallocate(*cur, buffer_size);
                 *cur = nullptr;
             }
 
@@ -416,10 +836,13 @@ namespace mystl {
 
     }
 
-    template<class T>
-    typename deque<T>::map_pointer deque<T>::create_map(size_type size) {
-        map_pointer mp = nullptr;
-        mp = map_allocator::allocate(size);
+    template<class T, class Alloc>
+    typename deque<T, Alloc>::map_pointer deque<T, Alloc>::create_map(size_type &size) {
+        // map 是指针数组，分配器多给出的空间都可以作为空位，减少以后重新分配map的次数
+        map_allocator alloc = map_alloc();
+        auto result = mystl::allocator_traits<map_allocator>::allocate_at_least(alloc, size);
+        map_pointer mp = result.ptr;
+        size = result.count;
         for (size_type i = 0; i < size; ++i) {
             // 让map中的每一个指针都指向空
             *(mp + i) = nullptr;
@@ -427,8 +850,20 @@ namespace mystl {
         return mp;
     }
 
-    template<class T>
-    void deque<T>::map_init(size_type nelem) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::map_init(size_type nelem) {
+        if (nelem == 0) {
+            map_ = nullptr;
+            map_size_ = 0;
+            begin_ = iterator();
+            end_ = iterator();
+            return;
+        }
+        create_map_and_buffer(nelem);
+    }
+
+    template<class T, class Alloc>
+    void deque<T, Alloc>::create_map_and_buffer(size_type nelem) {
         // 需要分配的缓冲区的个数
         const size_type nnode = nelem / buffer_size + 1;
         map_size_ = mystl::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), nnode + 2);
@@ -446,7 +881,7 @@ namespace mystl {
         try {
             create_buffer(nstart, nfinish);
         } catch (...) {
-            map_allocator::deallocate(map_, map_size_);
+            map_alloc().deallocate(map_, map_size_);
             map_size_ = 0;
             map_ = nullptr;
             throw;
@@ -461,8 +896,8 @@ namespace mystl {
 
     }
 
-    template<class T>
-    void deque<T>::fill_init(size_type n, const value_type &value) {
+    template<class T, class Alloc>
+    void deque<T, Alloc>::fill_init(size_type n, const value_type &value) {
         // 构造可以装下n个数字的map
         map_init(n);
         // 现在才开始赋值
@@ -473,4 +908,13 @@ namespace mystl {
             mystl::uninitialized_fill(end_.first, end_.cur, value);
         }
     }
-}
\ No newline at end of file
+
+    // 使用多态内存资源的deque，polymorphic_allocator 定义在 memory_resource.h 中，使用时需要包含它
+    namespace pmr {
+        template<class T>
+        class polymorphic_allocator;
+
+        template<class T>
+        using deque = mystl::deque<T, polymorphic_allocator<T>>;
+    }
+}
@@ -0,0 +1,112 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_GROWTH_POLICY_H
+#define STL_GROWTH_POLICY_H
+#pragma once
+
+#include <cstddef>
+
+#include "allocator.h"
+
+// 这个头文件包含 vector 的容量增长策略，作为 vector 的第三个模板参数
+// 每个策略提供：
+//     min_capacity                                   第一次分配时的最小容量，为 0 时默认构造不分配内存
+//     grow(old_cap, required, max_n, elem_size)      容量不够时的新容量，不小于 required，不大于 max_n
+//     fit(n, elem_size)                              reserve、shrink_to_fit 这类精确请求的容量，不小于 n
+// 默认的 default_growth 和原来的行为一样：翻倍，最小 16
+
+namespace mystl
+{
+    /*****************************************************************************************/
+    // geometric_growth
+    // 容量乘以 Num / Den（比如 2/1 翻倍，3/2 是 1.5 倍），最小为 Min
+    /*****************************************************************************************/
+    template <size_t Num = 2, size_t Den = 1, size_t Min = 16>
+    struct geometric_growth
+    {
+        static_assert(Den != 0 && Num > Den, "growth factor must be greater than 1");
+
+        static constexpr size_t min_capacity = Min;
+
+        static size_t grow(size_t old_cap, size_t required, size_t max_n, size_t) noexcept
+        {
+            if (old_cap == 0)
+            {
+                return required < Min ? (Min < max_n ? Min : max_n) : required;
+            }
+            // old_cap * Num / Den，分开计算避免溢出
+            const size_t extra = old_cap / Den * (Num - Den) + old_cap % Den * (Num - Den) / Den;
+            if (extra > max_n - old_cap)
+            {
+                return required > max_n ? required : max_n;
+            }
+            const size_t cap = old_cap + extra;
+            return cap < required ? required : cap;
+        }
+
+        static size_t fit(size_t n, size_t) noexcept
+        {
+            return n;
+        }
+    };
+
+    typedef geometric_growth<2, 1, 16> default_growth;
+
+    // 1.5 倍增长，释放的旧空间有机会被后面的分配重用
+    typedef geometric_growth<3, 2, 16> half_growth;
+
+    /*****************************************************************************************/
+    // exact_growth
+    // 每次只分配需要的大小，默认构造不分配内存，适合数量很多、大小固定的小 vector，不适合不断 push_back
+    /*****************************************************************************************/
+    struct exact_growth
+    {
+        static constexpr size_t min_capacity = 0;
+
+        static size_t grow(size_t, size_t required, size_t, size_t) noexcept
+        {
+            return required;
+        }
+
+        static size_t fit(size_t n, size_t) noexcept
+        {
+            return n;
+        }
+    };
+
+    /*****************************************************************************************/
+    // size_class_growth
+    // 在 Base 的基础上把容量上调到 malloc 实际分配的大小（malloc_good_size，见 allocator.h），
+    // 分配器没有 allocate_at_least 时也能利用 chunk 尾部的空间
+    /*****************************************************************************************/
+    template <class Base = default_growth>
+    struct size_class_growth
+    {
+        static constexpr size_t min_capacity = Base::min_capacity;
+
+        static size_t grow(size_t old_cap, size_t required, size_t max_n, size_t elem_size) noexcept
+        {
+            return round(Base::grow(old_cap, required, max_n, elem_size), max_n, elem_size);
+        }
+
+        static size_t fit(size_t n, size_t elem_size) noexcept
+        {
+            return round(Base::fit(n, elem_size), static_cast<size_t>(-1) / elem_size, elem_size);
+        }
+
+    private:
+        static size_t round(size_t n, size_t max_n, size_t elem_size) noexcept
+        {
+            if (n == 0 || n >= max_n / 2)
+            {
+                return n;
+            }
+            const size_t cap = malloc_good_size(n * elem_size) / elem_size;
+            return cap < n ? n : cap;
+        }
+    };
+}
+
+#endif //STL_GROWTH_POLICY_H
@@ -0,0 +1,223 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_HARDENING_H
+#define STL_HARDENING_H
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+
+#include "iterator.h"
+
+// 这个头文件包含容器的检查级别，编译时通过 MYSTL_HARDENING_LEVEL 选择，整个程序必须使用同一个级别
+// 0（默认）：和原来一样只有 assert，定义 NDEBUG 之后没有任何检查，生成的代码和没有这个头文件时相同
+// 1：下标、front/back、pop、insert/erase 的位置等廉价的边界检查，失败时打印位置并 abort，不受 NDEBUG 影响
+// 2：在 1 的基础上检查迭代器是否失效：
+//    vector 的迭代器记录所属的容器和取得时容器的代数（generation），重新分配、交换让代数加一，
+//    之后再使用原来的迭代器（解引用、移动、比较）会被发现，解引用时还检查是否在 [begin, end) 中；
+//    deque 的迭代器同样记录代数，push_front/push_back 让代数加一；list 的迭代器检查是否解引用了 end()
+//    容器被移动或交换之后，原来的迭代器即使按标准仍然有效也会被报告，使用 level 2 时应避免这种写法
+// 无论哪个级别，at() 越界都抛出 std::out_of_range
+
+#ifndef MYSTL_HARDENING_LEVEL
+#define MYSTL_HARDENING_LEVEL 0
+#endif
+
+namespace mystl
+{
+    // 检查失败时调用，不返回
+    [[noreturn]] inline void hardening_fail(const char* file, int line, const char* msg) noexcept
+    {
+        std::fprintf(stderr, "%s:%d: mystl hardening check failed: %s\n", file, line, msg);
+        std::abort();
+    }
+}
+
+// MYSTL_HARDENING_ASSERT 用于边界检查，level 0 时就是 assert
+#if MYSTL_HARDENING_LEVEL >= 1
+#define MYSTL_HARDENING_ASSERT(cond, msg) \
+    ((cond) ? static_cast<void>(0) : mystl::hardening_fail(__FILE__, __LINE__, msg))
+#else
+#define MYSTL_HARDENING_ASSERT(cond, msg) assert(cond)
+#endif
+
+// MYSTL_ITERATOR_ASSERT 用于迭代器有效性的检查，只在 level 2 生效
+#if MYSTL_HARDENING_LEVEL >= 2
+#define MYSTL_ITERATOR_ASSERT(cond, msg) MYSTL_HARDENING_ASSERT(cond, msg)
+#else
+#define MYSTL_ITERATOR_ASSERT(cond, msg) static_cast<void>(0)
+#endif
+
+namespace mystl
+{
+    /*****************************************************************************************/
+    // checked_iterator
+    // level 2 时连续存储的容器（vector）使用的迭代器，T 为 value_type 或 const value_type
+    // Container 需要向它开放 checked_begin()、checked_end()、checked_generation() 三个函数
+    /*****************************************************************************************/
+    template <class T, class Container>
+    class checked_iterator : public mystl::iterator<mystl::random_access_iterator_tag,
+            typename std::remove_const<T>::type, ptrdiff_t, T*, T&>
+    {
+        template <class, class> friend class checked_iterator;
+
+    public:
+        typedef T* pointer;
+        typedef T& reference;
+        typedef ptrdiff_t difference_type;
+        typedef checked_iterator self;
+
+    private:
+        T*               ptr_;
+        const Container* owner_;
+        size_t           gen_;   // 取得迭代器时容器的代数
+
+    public:
+        checked_iterator() noexcept : ptr_(nullptr), owner_(nullptr), gen_(0) {}
+
+        checked_iterator(T* ptr, const Container* owner) noexcept
+                : ptr_(ptr), owner_(owner), gen_(owner->checked_generation()) {}
+
+        // iterator 可以转换为 const_iterator
+        template <class U, typename std::enable_if<std::is_same<const U, T>::value &&
+                                                   !std::is_same<U, T>::value, int>::type = 0>
+        checked_iterator(const checked_iterator<U, Container>& rhs) noexcept
+                : ptr_(rhs.ptr_), owner_(rhs.owner_), gen_(rhs.gen_) {}
+
+        // 不做检查，直接取得指针
+        T* base() const noexcept { return ptr_; }
+
+        // 迭代器属于 owner 并且没有失效
+        void check_owner(const Container* owner) const
+        {
+            MYSTL_ITERATOR_ASSERT(owner_ == owner, "iterator does not belong to this container");
+            check_valid();
+        }
+
+        void check_valid() const
+        {
+            MYSTL_ITERATOR_ASSERT(owner_ != nullptr, "use of a singular iterator");
+            MYSTL_ITERATOR_ASSERT(gen_ == owner_->checked_generation(), "use of an invalidated iterator");
+        }
+
+        template <class U>
+        void check_comparable(const checked_iterator<U, Container>& rhs) const
+        {
+            MYSTL_ITERATOR_ASSERT(owner_ == rhs.owner_, "comparison of iterators from different containers");
+            if (owner_ != nullptr)
+            {
+                check_valid();
+                rhs.check_valid();
+            }
+        }
+
+        reference operator*() const
+        {
+            check_valid();
+            MYSTL_ITERATOR_ASSERT(owner_->checked_begin() <= ptr_ && ptr_ < owner_->checked_end(),
+                                  "dereference of an out of range iterator");
+            return *ptr_;
+        }
+
+        pointer operator->() const { return &(operator*()); }
+
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        self& operator+=(difference_type n)
+        {
+            check_valid();
+            const difference_type pos = ptr_ - owner_->checked_begin();
+            MYSTL_ITERATOR_ASSERT(pos + n >= 0 && pos + n <= owner_->checked_end() - owner_->checked_begin(),
+                                  "iterator moved out of range");
+            ptr_ += n;
+            return *this;
+        }
+
+        self& operator-=(difference_type n) { return *this += -n; }
+
+        self& operator++() { return *this += 1; }
+
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self& operator--() { return *this += -1; }
+
+        self operator--(int)
+        {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        self operator+(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp += n;
+        }
+
+        self operator-(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp -= n;
+        }
+
+        friend self operator+(difference_type n, const self& it) { return it + n; }
+    };
+
+    // 比较和相减，iterator 和 const_iterator 之间也可以进行
+    template <class T1, class T2, class Container>
+    ptrdiff_t operator-(const checked_iterator<T1, Container>& lhs, const checked_iterator<T2, Container>& rhs)
+    {
+        lhs.check_comparable(rhs);
+        return lhs.base() - rhs.base();
+    }
+
+    template <class T1, class T2, class Container>
+    bool operator==(const checked_iterator<T1, Container>& lhs, const checked_iterator<T2, Container>& rhs)
+    {
+        lhs.check_comparable(rhs);
+        return lhs.base() == rhs.base();
+    }
+
+    template <class T1, class T2, class Container>
+    bool operator!=(const checked_iterator<T1, Container>& lhs, const checked_iterator<T2, Container>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T1, class T2, class Container>
+    bool operator<(const checked_iterator<T1, Container>& lhs, const checked_iterator<T2, Container>& rhs)
+    {
+        lhs.check_comparable(rhs);
+        return lhs.base() < rhs.base();
+    }
+
+    template <class T1, class T2, class Container>
+    bool operator>(const checked_iterator<T1, Container>& lhs, const checked_iterator<T2, Container>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T1, class T2, class Container>
+    bool operator<=(const checked_iterator<T1, Container>& lhs, const checked_iterator<T2, Container>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T1, class T2, class Container>
+    bool operator>=(const checked_iterator<T1, Container>& lhs, const checked_iterator<T2, Container>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+}
+
+#endif //STL_HARDENING_H
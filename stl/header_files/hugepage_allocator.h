@@ -0,0 +1,261 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_HUGEPAGE_ALLOCATOR_H
+#define STL_HUGEPAGE_ALLOCATOR_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "allocator.h"
+#include "construct.h"
+#include "utils.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// 这个头文件包含模板类 hugepage_allocator，用于几百 MiB 的大缓冲区（比如批处理中不断增长的 vector）
+// 小于 Threshold 字节的请求和 allocator 一样；不小于 Threshold 的请求用 mmap 按 2 MiB 对齐映射，
+// 并用 madvise(MADV_HUGEPAGE) 请求透明大页，减少顺序扫描时的 TLB 缺失
+// 另外提供 reallocate，用 mremap 扩展映射而不是 分配 + 搬移 + 释放，vector 在尾部插入且元素可以按位搬移时使用它
+// 不是 Linux 或者内核不支持透明大页时，退化为普通的映射或 ::operator new
+
+// 默认的阈值
+#ifndef MYSTL_HUGEPAGE_THRESHOLD
+#define MYSTL_HUGEPAGE_THRESHOLD (4 * 1024 * 1024)
+#endif
+
+namespace mystl
+{
+    /*****************************************************************************************/
+    // hugepage_impl
+    // 和类型无关的映射、扩展、释放
+    /*****************************************************************************************/
+    class hugepage_impl
+    {
+    public:
+        enum { HUGEPAGE_SIZE = 2 * 1024 * 1024 };
+
+        // 映射的长度，上调到大页的整数倍
+        static size_t map_length(size_t bytes) noexcept
+        {
+            return (bytes + HUGEPAGE_SIZE - 1) & ~(static_cast<size_t>(HUGEPAGE_SIZE) - 1);
+        }
+
+#if defined(__linux__)
+        // 多映射一个大页，再把首尾多余的部分解除映射，得到 2 MiB 对齐的区域
+        static void* map(size_t bytes)
+        {
+            const size_t len = map_length(bytes);
+            void* raw = ::mmap(nullptr, len + HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+            const uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+            const uintptr_t aligned = (begin + HUGEPAGE_SIZE - 1) & ~(static_cast<uintptr_t>(HUGEPAGE_SIZE) - 1);
+            if (aligned != begin)
+            {
+                ::munmap(raw, aligned - begin);
+            }
+            const size_t tail = (begin + len + HUGEPAGE_SIZE) - (aligned + len);
+            if (tail != 0)
+            {
+                ::munmap(reinterpret_cast<void*>(aligned + len), tail);
+            }
+            advise(reinterpret_cast<void*>(aligned), len);
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        static void unmap(void* ptr, size_t bytes) noexcept
+        {
+            ::munmap(ptr, map_length(bytes));
+        }
+
+        // 扩展（或收缩）映射，内核只移动页表不复制数据，失败时返回 nullptr，原来的映射不变
+        static void* remap(void* ptr, size_t old_bytes, size_t new_bytes) noexcept
+        {
+            const size_t old_len = map_length(old_bytes);
+            const size_t new_len = map_length(new_bytes);
+            if (old_len == new_len)
+            {
+                return ptr;
+            }
+#if defined(MREMAP_MAYMOVE)
+            void* p = ::mremap(ptr, old_len, new_len, MREMAP_MAYMOVE);
+            if (p == MAP_FAILED)
+            {
+                return nullptr;
+            }
+            advise(p, new_len);
+            return p;
+#else
+            return nullptr;
+#endif
+        }
+
+    private:
+        // 内核不支持透明大页时 madvise 失败，忽略即可，仍然是普通的映射
+        static void advise(void* ptr, size_t len) noexcept
+        {
+#if defined(MADV_HUGEPAGE)
+            ::madvise(ptr, len, MADV_HUGEPAGE);
+#else
+            (void)ptr;
+            (void)len;
+#endif
+        }
+#else
+        static void* map(size_t bytes)
+        {
+            return mystl::aligned_allocate(map_length(bytes), HUGEPAGE_SIZE);
+        }
+
+        static void unmap(void* ptr, size_t bytes) noexcept
+        {
+            mystl::aligned_deallocate(ptr, map_length(bytes), HUGEPAGE_SIZE);
+        }
+
+        static void* remap(void*, size_t, size_t) noexcept
+        {
+            return nullptr;
+        }
+#endif
+    };
+
+    /*****************************************************************************************/
+    // hugepage_allocator
+    // Threshold 为使用大页映射的最小字节数
+    /*****************************************************************************************/
+    template <class T, size_t Threshold = MYSTL_HUGEPAGE_THRESHOLD>
+    class hugepage_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef hugepage_allocator<U, Threshold> other;
+        };
+
+    private:
+        static bool use_map(size_type n) noexcept
+        {
+            return n * sizeof(T) >= Threshold;
+        }
+
+    public:
+        hugepage_allocator() noexcept = default;
+
+        template <class U>
+        hugepage_allocator(const hugepage_allocator<U, Threshold>&) noexcept {}
+
+        static T* allocate()
+        {
+            return allocate(1);
+        }
+
+        static T* allocate(size_type n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            if (use_map(n))
+            {
+                return static_cast<T*>(hugepage_impl::map(n * sizeof(T)));
+            }
+            return mystl::allocator<T>::allocate(n);
+        }
+
+        // 映射的请求上调到大页的整数倍，整个映射都可以放元素
+        static allocation_result<T*> allocate_at_least(size_type n)
+        {
+            if (!use_map(n))
+            {
+                // 上调之后的个数也不能越过阈值，否则释放时会按映射 munmap 掉 ::operator new 的内存，
+                // 可能越过时不上调，按请求的个数分配
+                if (mystl::malloc_good_size(n * sizeof(T)) >= Threshold)
+                {
+                    return {mystl::allocator<T>::allocate(n), n};
+                }
+                return mystl::allocator<T>::allocate_at_least(n);
+            }
+            const size_type count = hugepage_impl::map_length(n * sizeof(T)) / sizeof(T);
+            return {allocate(count), count};
+        }
+
+        static void deallocate(T* ptr)
+        {
+            deallocate(ptr, 1);
+        }
+
+        // n 必须和 allocate（或 reallocate）时一致，用它区分内存来自映射还是 ::operator new
+        static void deallocate(T* ptr, size_type n)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+            if (use_map(n))
+            {
+                hugepage_impl::unmap(ptr, n * sizeof(T));
+                return;
+            }
+            mystl::allocator<T>::deallocate(ptr, n);
+        }
+
+        // 只有新旧两块都是映射时才能扩展，否则返回 nullptr，由调用者 分配 + 搬移 + 释放
+        // 成功时按位保留原来的内容，所以只能用于可以按位搬移的元素
+        static T* reallocate(T* ptr, size_type old_n, size_type new_n) noexcept
+        {
+            if (ptr == nullptr || !use_map(old_n) || !use_map(new_n))
+            {
+                return nullptr;
+            }
+            return static_cast<T*>(hugepage_impl::remap(ptr, old_n * sizeof(T), new_n * sizeof(T)));
+        }
+
+        template <class... Args>
+        static void construct(T* ptr, Args&&... args)
+        {
+            mystl::construct(ptr, mystl::forward<Args>(args)...);
+        }
+
+        static void destroy(T* ptr)
+        {
+            mystl::destroy(ptr);
+        }
+
+        static void destroy(T* first, T* last)
+        {
+            mystl::destroy(first, last);
+        }
+    };
+
+    template <class T, class U, size_t Threshold>
+    bool operator==(const hugepage_allocator<T, Threshold>&, const hugepage_allocator<U, Threshold>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U, size_t Threshold>
+    bool operator!=(const hugepage_allocator<T, Threshold>&, const hugepage_allocator<U, Threshold>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif //STL_HUGEPAGE_ALLOCATOR_H
@@ -6,6 +6,7 @@
 #define STL_LIST_H
 
 #endif //STL_LIST_H
+#pragma once
 
 #include "allocator.h"
 #include "utils.h"
@@ -14,6 +15,8 @@
 #include "uninitialized.h"
 #include "iterator.h"
 #include "memory.h"
+#include "trace.h"
+#include "hardening.h"
 
 #include <cassert>
 #include <iostream>
@@ -93,22 +96,32 @@ namespace mystl {
 
         base_ptr node_; // 指向当前节点
 
-        // 构造函数
-        list_iterator() = default;
+#if MYSTL_HARDENING_LEVEL >= 2
+        base_ptr head_ = nullptr; // 所属 list 的头节点，即 end()，为空时不检查
 
-        list_iterator(base_ptr x) : node_(x) {
-            std::cout << "list_iterator(base_ptr x)" << std::endl;
-        }
+        list_iterator(base_ptr x, base_ptr head) : node_(x), head_(head) {}
 
+        list_iterator(const list_iterator &rhs) : node_(rhs.node_), head_(rhs.head_) {}
+#else
         list_iterator(const list_iterator &rhs) : node_(rhs.node_) {}
+#endif
+
+        // 构造函数
+        list_iterator() = default;
+
+        list_iterator(base_ptr x) : node_(x) {}
 
         // 由于不能使用默认指针操作，所以必须重载 ,且注意，在取×的时候会as_node，相当于一个地址，若as_base就没有value，若as_node就有value
-        reference operator*() const { return node_->as_node()->value; }
+        reference operator*() const {
+            MYSTL_ITERATOR_ASSERT(node_ != head_, "dereference of list end() iterator");
+            return node_->as_node()->value;
+        }
 
         pointer operator->() const { return &(operator*()); }
 
         // 前++
         self &operator++() {
+            MYSTL_ITERATOR_ASSERT(node_ != head_, "increment of list end() iterator");
             node_ = node_->next;
             return *this;
         }
@@ -151,25 +164,42 @@ namespace mystl {
 
         base_ptr node_;
 
-        list_const_iterator() = default;
+#if MYSTL_HARDENING_LEVEL >= 2
+        base_ptr head_ = nullptr;
 
-        list_const_iterator(base_ptr x)
-                : node_(x) {}
+        list_const_iterator(base_ptr x, base_ptr head)
+                : node_(x), head_(head) {}
 
-        list_const_iterator(node_ptr x)
-                : node_(x->as_base()) {}
+        list_const_iterator(const list_iterator<T> &rhs)
+                : node_(rhs.node_), head_(rhs.head_) {}
 
+        list_const_iterator(const list_const_iterator &rhs)
+                : node_(rhs.node_), head_(rhs.head_) {}
+#else
         list_const_iterator(const list_iterator<T> &rhs)
                 : node_(rhs.node_) {}
 
         list_const_iterator(const list_const_iterator &rhs)
                 : node_(rhs.node_) {}
+#endif
 
-        reference operator*() const { return node_->as_node()->value; }
+        list_const_iterator() = default;
+
+        list_const_iterator(base_ptr x)
+                : node_(x) {}
+
+        list_const_iterator(node_ptr x)
+                : node_(x->as_base()) {}
+
+        reference operator*() const {
+            MYSTL_ITERATOR_ASSERT(node_ != head_, "dereference of list end() iterator");
+            return node_->as_node()->value;
+        }
 
         pointer operator->() const { return &(operator*()); }
 
         self &operator++() {
+            MYSTL_ITERATOR_ASSERT(node_ != head_, "increment of list end() iterator");
             node_ = node_->next;
             return *this;
         }
@@ -197,23 +227,25 @@ namespace mystl {
         bool operator!=(const self &rhs) const { return node_ != rhs.node_; }
     };
 
-    // list类
-    template<class T>
-    class list {
+    // list类，保存的是节点的分配器，数据和头节点的分配器需要时由它 rebind 得到
+    template<class T, class Alloc = mystl::allocator<T>>
+    class list : private mystl::alloc_holder<
+            typename mystl::allocator_traits<Alloc>::template rebind_alloc<list_node<T>>> {
     public:
-        typedef typename mystl::allocator<T> allocator_type;
-        typedef typename mystl::allocator<T> data_allocator;
+        typedef Alloc allocator_type;
+        typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> data_allocator;
 
-        typedef typename mystl::allocator<list_node<T>> node_allocator;
-        typedef typename mystl::allocator<list_node_base<T>> base_allocator;
+        typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<list_node<T>> node_allocator;
+        typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<list_node_base<T>> base_allocator;
+        typedef mystl::allocator_traits<node_allocator> alloc_traits;
 
-        typedef typename allocator_type::value_type value_type;
-        typedef typename allocator_type::pointer pointer;
-        typedef typename allocator_type::const_pointer const_pointer;
-        typedef typename allocator_type::reference reference;
-        typedef typename allocator_type::const_reference const_reference;
-        typedef typename allocator_type::size_type size_type;
-        typedef typename allocator_type::difference_type difference_type;
+        typedef typename data_allocator::value_type value_type;
+        typedef typename data_allocator::pointer pointer;
+        typedef typename data_allocator::const_pointer const_pointer;
+        typedef typename data_allocator::reference reference;
+        typedef typename data_allocator::const_reference const_reference;
+        typedef typename data_allocator::size_type size_type;
+        typedef typename data_allocator::difference_type difference_type;
 
         typedef list_iterator<T> iterator;
         typedef list_const_iterator<T> const_iterator;
@@ -222,6 +254,27 @@ namespace mystl {
         typedef typename node_traits<T>::node_ptr node_ptr;
 
     private:
+        typedef mystl::alloc_holder<node_allocator> alloc_base;
+
+        node_allocator &node_alloc() noexcept { return this->get_alloc(); }
+
+        const node_allocator &node_alloc() const noexcept { return this->get_alloc(); }
+
+        data_allocator data_alloc() const noexcept { return data_allocator(node_alloc()); }
+
+        base_allocator base_alloc() const noexcept { return base_allocator(node_alloc()); }
+
+#if MYSTL_HARDENING_LEVEL >= 2
+        // 迭代器记录头节点，解引用 end() 时可以发现
+        iterator make_iter(base_ptr x) noexcept { return iterator(x, node_); }
+
+        const_iterator make_iter(base_ptr x) const noexcept { return const_iterator(x, node_); }
+#else
+        iterator make_iter(base_ptr x) noexcept { return x; }
+
+        const_iterator make_iter(base_ptr x) const noexcept { return x; }
+#endif
+
         base_ptr node_; // 由于是环状链表，必须要保留一个不存放数据的节点，保证左闭右开
         size_type size_; // 大小
 
@@ -232,62 +285,115 @@ namespace mystl {
             fill_init(0, value_type());
         }
 
-        explicit list(size_type n) {
+        // 使用指定的分配器实例
+        explicit list(const allocator_type &alloc) : alloc_base(node_allocator(alloc)) {
+            fill_init(0, value_type());
+        }
+
+        explicit list(size_type n, const allocator_type &alloc = allocator_type())
+                : alloc_base(node_allocator(alloc)) {
             fill_init(n, value_type());
         }
 
-        list(size_type n, const T &value) {
+        list(size_type n, const T &value, const allocator_type &alloc = allocator_type())
+                : alloc_base(node_allocator(alloc)) {
             fill_init(n, value);
         }
 
-        list(std::initializer_list<T> ilist) {
+        list(std::initializer_list<T> ilist, const allocator_type &alloc = allocator_type())
+                : alloc_base(node_allocator(alloc)) {
             copy_init(ilist.begin(), ilist.end());
         }
 
-        // 拷贝构造
-        list(const list &rhs) {
-            std::cout << "list(const list &rhs)" << std::endl;
+        // 拷贝构造，分配器由 select_on_container_copy_construction 决定
+        list(const list &rhs)
+                : alloc_base(alloc_traits::select_on_container_copy_construction(rhs.node_alloc())) {
+            MYSTL_TRACE_SCOPE("list(const list& rhs)", this, size_);
             copy_init(rhs.begin(), rhs.end());
         }
 
-        // 移动构造
-        list(list &&rhs) noexcept: node_(rhs.node_), size_(rhs.size_) {
-            std::cout << "list(list &&rhs)" << std::endl;
+        // 移动构造，分配器随节点一起移动过来
+        list(list &&rhs) noexcept: alloc_base(mystl::move(rhs.node_alloc())), node_(rhs.node_), size_(rhs.size_) {
+            MYSTL_TRACE_EVENT("list(list&& rhs)", this, size_);
             rhs.node_ = nullptr;
             rhs.size_ = 0;
         }
 
         // 拷贝赋值构造
         list &operator=(const list &rhs) {
-            std::cout << "list &operator=(const list &rhs)" << std::endl;
+            MYSTL_TRACE_SCOPE("list::operator=(const list& rhs)", this, size_);
             if (this != &rhs) {
+                if (alloc_traits::propagate_on_container_copy_assignment::value &&
+                    !alloc_traits::equal(node_alloc(), rhs.node_alloc())) {
+                    // 原来的节点（包括头节点）必须用原来的分配器释放，再换成rhs的分配器
+                    release();
+                    node_alloc() = rhs.node_alloc();
+                    fill_init(0, value_type());
+                } else if (alloc_traits::propagate_on_container_copy_assignment::value) {
+                    node_alloc() = rhs.node_alloc();
+                }
                 assign(rhs.begin(), rhs.end());
             }
             return *this;
         }
 
         // 移动赋值构造
-        list &operator=(list &&rhs) noexcept {
-            splice(end(), rhs);
+        list &operator=(list &&rhs) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                             alloc_traits::is_always_equal::value) {
+            if (this != &rhs) {
+                if (alloc_traits::propagate_on_container_move_assignment::value) {
+                    // 连同分配器一起接管rhs，原来的头节点用原来的分配器释放
+                    clear();
+                    release();
+                    node_alloc() = mystl::move(rhs.node_alloc());
+                    node_ = rhs.node_;
+                    size_ = rhs.size_;
+                    rhs.node_ = nullptr;
+                    rhs.size_ = 0;
+                } else if (alloc_traits::equal(node_alloc(), rhs.node_alloc())) {
+                    // 分配器相等，节点可以直接接过来
+                    clear();
+                    splice(end(), rhs);
+                } else {
+                    move_assign_unequal(rhs);
+                }
+            }
             return *this;
         }
 
+        ~list() {
+            release();
+        }
+
+        allocator_type get_allocator() const {
+            return allocator_type(node_alloc());
+        }
+
+        // swap 将自己和rhs交换，propagate_on_container_swap 为真时连同分配器一起交换
+        void swap(list &rhs) noexcept {
+            mystl::swap(node_, rhs.node_);
+            mystl::swap(size_, rhs.size_);
+            if (alloc_traits::propagate_on_container_swap::value) {
+                mystl::swap(node_alloc(), rhs.node_alloc());
+            }
+        }
+
 
         // 迭代器操作,begin的时候就next
         iterator begin() noexcept {
-            return node_->next;
+            return make_iter(node_->next);
         }
 
         const_iterator begin() const noexcept {
-            return node_->next;
+            return make_iter(node_->next);
         }
 
         iterator end() noexcept {
-            return node_;
+            return make_iter(node_);
         }
 
         const_iterator end() const noexcept {
-            return node_;
+            return make_iter(node_);
         }
 
         // 容器相关操作
@@ -305,10 +411,12 @@ namespace mystl {
 
         // reference 就是int& 感觉可以用value_type
         reference front() {
+            MYSTL_HARDENING_ASSERT(!empty(), "list::front() on empty list");
             return *begin();
         }
 
         reference back() {
+            MYSTL_HARDENING_ASSERT(!empty(), "list::back() on empty list");
             return *(--end());
         }
 
@@ -327,8 +435,45 @@ namespace mystl {
             copy_assign(ilist.begin(), ilist.end());
         }
 
+        // splice 把 rhs 的节点接到 pos 之前，不复制元素，两个 list 的分配器必须相等
         void splice(const_iterator pos, list &rhs);
 
+        void splice(const_iterator pos, list &rhs, const_iterator it);
+
+        void splice(const_iterator pos, list &rhs, const_iterator first, const_iterator last);
+
+        // merge 把有序的 rhs 合并进来，稳定，只改变节点的连接
+        void merge(list &rhs) {
+            merge(rhs, mystl::less_than());
+        }
+
+        template<class Compared>
+        void merge(list &rhs, Compared comp);
+
+        // sort 自底向上的归并排序，稳定，只改变节点的连接，不复制元素，额外空间为固定大小的数组
+        void sort() {
+            sort(mystl::less_than());
+        }
+
+        template<class Compared>
+        void sort(Compared comp);
+
+        // unique 删除相邻的重复元素，只保留第一个，返回删除的个数
+        size_type unique() {
+            return unique(mystl::equal_to());
+        }
+
+        template<class BinaryPredicate>
+        size_type unique(BinaryPredicate pred);
+
+        // remove_if / remove 删除满足条件的元素，返回删除的个数，value 可以是list中的元素
+        template<class UnaryPredicate>
+        size_type remove_if(UnaryPredicate pred);
+
+        size_type remove(const value_type &value) {
+            return remove_if([&value](const value_type &x) { return x == value; });
+        }
+
         template<class iter>
         iterator insert(const_iterator pos, iter first, iter second) {
             size_type n = mystl::distance(first, second);
@@ -346,6 +491,7 @@ namespace mystl {
         void push_back(const value_type &value);
 
         void pop_front() {
+            MYSTL_HARDENING_ASSERT(!empty(), "list::pop_front() on empty list");
             auto node = node_->next;
             unlink_nodes(node, node);
             destroy_node(node->as_node());
@@ -353,6 +499,7 @@ namespace mystl {
         }
 
         void pop_back() {
+            MYSTL_HARDENING_ASSERT(!empty(), "list::pop_back() on empty list");
             auto node = node_->prev;
             unlink_nodes(node, node);
             destroy_node(node->as_node());
@@ -369,6 +516,13 @@ namespace mystl {
 
         // 容器辅助函数
 
+        // 销毁所有节点和头节点，析构以及更换分配器之前使用
+        void release();
+
+        // 移动赋值时分配器不相等，只能用自己的分配器逐个移动元素
+        // 单独成为一个函数：分配器总是相等时这里不会被调用，可能抛出的节点分配不会出现在 noexcept 的 operator= 中
+        void move_assign_unequal(list &rhs);
+
         iterator link_iter_node(const_iterator pos, base_ptr node);
 
         template<class iter>
@@ -399,26 +553,48 @@ namespace mystl {
 
         void unlink_nodes(base_ptr first, base_ptr last);
 
+        // 排序时使用的单向链：只用 next 连接，以 nullptr 结尾，排完之后再恢复 prev
+        template<class Compared>
+        void merge_chains(base_ptr &first, base_ptr second, Compared &comp);
+
+        void link_chain_at_back(base_ptr chain);
+
+        void destroy_chain(base_ptr chain);
+
 //        void link_nodes_at_back(node_ptr node);
     };
 
 //--------------------------------------方法实现------------------------------
 
-    template<class T>
-    void list<T>::resize(size_type new_size, const value_type &value) {
+    // 先把元素移动到用自己的分配器创建的 temp 中，全部成功之后才替换原来的元素，中途抛出异常时 *this 不变
+    template<class T, class Alloc>
+    void list<T, Alloc>::move_assign_unequal(list &rhs) {
+        list temp(get_allocator());
+        for (auto it = rhs.begin(); it != rhs.end(); ++it) {
+            auto node = temp.create_node(mystl::move(*it));
+            temp.link_nodes_at_back(node->as_base(), node->as_base());
+            ++temp.size_;
+        }
+        clear();
+        splice(end(), temp);
+        rhs.clear();
+    }
+
+    template<class T, class Alloc>
+    void list<T, Alloc>::resize(size_type new_size, const value_type &value) {
         auto i = begin();
 
     }
 
-    template<class T>
-    void list<T>::push_front(const value_type &value) {
+    template<class T, class Alloc>
+    void list<T, Alloc>::push_front(const value_type &value) {
         auto node = create_node(value);
         link_nodes_at_front(node->as_base(), node->as_base());
         ++size_;
     }
 
-    template<class T>
-    void list<T>::push_back(const value_type &value) {
+    template<class T, class Alloc>
+    void list<T, Alloc>::push_back(const value_type &value) {
         auto node = create_node(value);
         link_nodes_at_back(node->as_node(), node->as_node());
         ++size_;
@@ -428,7 +604,7 @@ namespace mystl {
 
 //    反面教材
 //    template<class T>
-//    void list<T>::link_nodes_at_back(node_ptr node) {
+//    void list<T, Alloc>::link_nodes_at_back(node_ptr node) {
 //        // 自己画一下当添加2个时候，其实把第一个就丢掉了
 //        std::cout << "link_nodes_at_back(node_ptr node)" << std::endl;
 //        node_->next = node;
@@ -456,9 +632,8 @@ namespace mystl {
      *
      *
      * */
-    template<class T>
-    void list<T>::link_nodes_at_back(base_ptr first, base_ptr last) {
-        std::cout << "link_nodes_at_back(base_ptr first, base_ptr last)" << std::endl;
+    template<class T, class Alloc>
+    void list<T, Alloc>::link_nodes_at_back(base_ptr first, base_ptr last) {
         last->next = node_;
         first->prev = node_->prev;
         first->prev->next = first;
@@ -507,8 +682,8 @@ namespace mystl {
 // ***************
 // link_nodes_at_front 在 头部连接 [first, last] 的结点
 // ***************
-    template<class T>
-    void list<T>::link_nodes_at_front(base_ptr first, base_ptr last) {
+    template<class T, class Alloc>
+    void list<T, Alloc>::link_nodes_at_front(base_ptr first, base_ptr last) {
         first->prev = node_;
         last->next = node_->next;
         last->next->prev = last;
@@ -561,8 +736,8 @@ namespace mystl {
      *   |     |       |     |       |     |        |     |     |     |        |     |
      *   |-----|       |-----|       |-----|        |-----|     |-----|        |-----|
      * */
-    template<class T>
-    void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) {
+    template<class T, class Alloc>
+    void list<T, Alloc>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) {
         pos->prev->next = first;
         first->prev = pos->prev;
         pos->prev = last;
@@ -588,8 +763,8 @@ namespace mystl {
      *   |-----|  |  |-----|            |-----|  |  |-----|
      *            |------------------------------|
      * */
-    template<class T>
-    void list<T>::unlink_nodes(base_ptr first, base_ptr last) {
+    template<class T, class Alloc>
+    void list<T, Alloc>::unlink_nodes(base_ptr first, base_ptr last) {
         first->prev->next = last->next; // pos的next不再指向first，指向本身
         last->next->prev = first->prev; // pos的prev不再指向last，指向本身
     }
@@ -597,8 +772,8 @@ namespace mystl {
 // ***************
 // link_iter_node 在pos处连接一个node
 // ***************
-    template<class T>
-    typename list<T>::iterator list<T>::link_iter_node(const_iterator pos, base_ptr node) {
+    template<class T, class Alloc>
+    typename list<T, Alloc>::iterator list<T, Alloc>::link_iter_node(const_iterator pos, base_ptr node) {
         if (pos == node_->next) {
             link_nodes_at_front(node, node);
         } else if (pos == node_) {
@@ -606,24 +781,24 @@ namespace mystl {
         } else {
             link_nodes(pos.node_, node, node);
         }
-        return iterator(node);
+        return make_iter(node);
     }
 
 // ***************
 // create_node
 // ***************
 
-    template<class T>
+    template<class T, class Alloc>
     template<class ...Args>
-    typename list<T>::node_ptr list<T>::create_node(Args &&...args) {
-        node_ptr p = node_allocator::allocate(1);
+    typename list<T, Alloc>::node_ptr list<T, Alloc>::create_node(Args &&...args) {
+        node_ptr p = node_alloc().allocate(1);
         try {
-            data_allocator::construct(mystl::address_of(p->value), mystl::forward<Args>(args)...);
+            data_alloc().construct(mystl::address_of(p->value), mystl::forward<Args>(args)...);
             p->prev = nullptr;
             p->next = nullptr;
 
         } catch (...) {
-            node_allocator::deallocate(p);
+            node_alloc().deallocate(p);
             throw;
         }
         return p;
@@ -632,9 +807,9 @@ namespace mystl {
 // ***************
 // fill_init 初始化n个value
 // ***************
-    template<class T>
-    void list<T>::fill_init(size_type n, const value_type &value) {
-        node_ = base_allocator::allocate(1); // 这个节点是最开始的节点
+    template<class T, class Alloc>
+    void list<T, Alloc>::fill_init(size_type n, const value_type &value) {
+        node_ = base_alloc().allocate(1); // 这个节点是最开始的节点
         node_->unlink();
         size_ = n;
         try {
@@ -646,7 +821,7 @@ namespace mystl {
             }
         } catch (...) {
             //clear();
-            base_allocator::deallocate(node_);
+            base_alloc().deallocate(node_);
             node_ = nullptr;
             throw;
         }
@@ -655,10 +830,10 @@ namespace mystl {
 // ***************
 // copy_init 以[first,second)初始化
 // ***************
-    template<class T>
+    template<class T, class Alloc>
     template<class iter>
-    void list<T>::copy_init(iter first, iter second) {
-        node_ = base_allocator::allocate(1);
+    void list<T, Alloc>::copy_init(iter first, iter second) {
+        node_ = base_alloc().allocate(1);
         node_->unlink();
         // 计算出两个迭代器的距离
         size_type n = mystl::distance(first, second);
@@ -669,7 +844,7 @@ namespace mystl {
                 link_nodes_at_back(node->as_base(), node->as_base());
             }
         } catch (...) {
-            base_allocator::deallocate(node_);
+            base_alloc().deallocate(node_);
             node_ = nullptr;
             throw;
         }
@@ -678,17 +853,17 @@ namespace mystl {
 // ***************
 // copy_assign 把[first,second)中的值复制过来
 // ***************
-    template<class T>
+    template<class T, class Alloc>
     template<class iter>
-    void list<T>::copy_assign(iter first, iter second) {
+    void list<T, Alloc>::copy_assign(iter first, iter second) {
         auto f1 = begin();
         auto l1 = end();
         for (; f1 != l1 && first != second; ++f1, ++first) {
             *f1 = *first;
         }
         if (first == second) {
-            // 表明需要赋值的元素为空，赋值后，原来的容器就相当于空
-            clear();
+            // 需要赋值的元素已经用完，把原来容器中多出来的[f1,l1)删除
+            erase(f1, l1);
 
         } else {
             insert(l1, first, second);
@@ -700,8 +875,8 @@ namespace mystl {
 // ***************
 // splice 将rhs接在pos之前
 // ***************
-    template<class T>
-    void list<T>::splice(const_iterator pos, list<T> &rhs) {
+    template<class T, class Alloc>
+    void list<T, Alloc>::splice(const_iterator pos, list<T, Alloc> &rhs) {
         // 用于移动赋值构造，所以需要把rhs去掉
         if (!rhs.empty()) {
             auto f = rhs.node_->next;
@@ -713,28 +888,300 @@ namespace mystl {
         }
     }
 
+// ***************
+// splice 将rhs中it所指的节点接在pos之前
+// ***************
+    template<class T, class Alloc>
+    void list<T, Alloc>::splice(const_iterator pos, list<T, Alloc> &rhs, const_iterator it) {
+        MYSTL_HARDENING_ASSERT(it.node_ != rhs.node_, "list::splice() of end()");
+        auto f = it.node_;
+        if (pos.node_ != f && pos.node_ != f->next) {
+            rhs.unlink_nodes(f, f);
+            link_nodes(pos.node_, f, f);
+            ++size_;
+            --rhs.size_;
+        }
+    }
+
+// ***************
+// splice 将rhs中的[first,last)接在pos之前，rhs就是自己时pos不能在[first,last)中
+// ***************
+    template<class T, class Alloc>
+    void list<T, Alloc>::splice(const_iterator pos, list<T, Alloc> &rhs, const_iterator first,
+                                const_iterator last) {
+        if (first != last && pos.node_ != last.node_) {
+            if (this != &rhs) {
+                size_type n = mystl::distance(first, last);
+                size_ += n;
+                rhs.size_ -= n;
+            }
+            auto f = first.node_;
+            auto l = last.node_->prev;
+            rhs.unlink_nodes(f, l);
+            link_nodes(pos.node_, f, l);
+        }
+    }
+
+// ***************
+// merge 将有序的rhs合并到有序的自己中，相等时自己的节点在前
+// ***************
+    template<class T, class Alloc>
+    template<class Compared>
+    void list<T, Alloc>::merge(list<T, Alloc> &rhs, Compared comp) {
+        if (this == &rhs) {
+            return;
+        }
+        auto f1 = node_->next;
+        auto f2 = rhs.node_->next;
+        while (f1 != node_ && f2 != rhs.node_) {
+            if (comp(f2->as_node()->value, f1->as_node()->value)) {
+                // 把rhs中连续的一段小于*f1的节点一起接到f1之前，边找边计数，comp抛出异常时size也是对的
+                auto l = f2;
+                size_type n = 1;
+                while (l->next != rhs.node_ && comp(l->next->as_node()->value, f1->as_node()->value)) {
+                    l = l->next;
+                    ++n;
+                }
+                auto next = l->next;
+                rhs.unlink_nodes(f2, l);
+                link_nodes(f1, f2, l);
+                size_ += n;
+                rhs.size_ -= n;
+                f2 = next;
+            }
+            f1 = f1->next;
+        }
+        splice(end(), rhs);
+    }
+
+// ***************
+// merge_chains 把有序的单向链second合并到有序的单向链first中，相等时first的节点在前
+// comp抛出异常时first为所有节点连成的一条链（不再有序），节点不会丢失
+// ***************
+    template<class T, class Alloc>
+    template<class Compared>
+    void list<T, Alloc>::merge_chains(base_ptr &first, base_ptr second, Compared &comp) {
+        base_ptr head = nullptr;
+        base_ptr *tail = &head;
+        base_ptr a = first;
+        try {
+            while (a != nullptr && second != nullptr) {
+                if (comp(second->as_node()->value, a->as_node()->value)) {
+                    *tail = second;
+                    tail = &second->next;
+                    second = second->next;
+                } else {
+                    *tail = a;
+                    tail = &a->next;
+                    a = a->next;
+                }
+            }
+        } catch (...) {
+            *tail = a;
+            while (*tail != nullptr) {
+                tail = &(*tail)->next;
+            }
+            *tail = second;
+            first = head;
+            throw;
+        }
+        *tail = a != nullptr ? a : second;
+        first = head;
+    }
+
+// ***************
+// link_chain_at_back 把单向链接到尾部，同时恢复prev
+// ***************
+    template<class T, class Alloc>
+    void list<T, Alloc>::link_chain_at_back(base_ptr chain) {
+        auto prev = node_->prev;
+        for (; chain != nullptr; chain = chain->next) {
+            prev->next = chain;
+            chain->prev = prev;
+            prev = chain;
+        }
+        prev->next = node_;
+        node_->prev = prev;
+    }
+
+// ***************
+// destroy_chain 销毁单向链中的所有节点
+// ***************
+    template<class T, class Alloc>
+    void list<T, Alloc>::destroy_chain(base_ptr chain) {
+        while (chain != nullptr) {
+            auto next = chain->next;
+            destroy_node(chain->as_node());
+            chain = next;
+        }
+    }
+
+// ***************
+// sort 自底向上的归并排序
+// ***************
+    /*
+     * 逐个取下节点作为长度为1的链carry，bins[i]为空或者是长度为2^i的有序链，
+     * 和二进制加一一样，carry依次与bins[0]、bins[1]...合并，直到遇到空的bins[i]放进去，
+     * 最后把所有bins从低到高合并起来；bins中下标越大的链中的节点越靠前，合并时放在前面，所以是稳定的
+     * 64个bins足够排任意长度的list，除此之外不需要额外的内存
+     * comp抛出异常时所有节点按不确定的顺序重新接回list，size不变
+     */
+    template<class T, class Alloc>
+    template<class Compared>
+    void list<T, Alloc>::sort(Compared comp) {
+        if (size_ < 2) {
+            return;
+        }
+        base_ptr bins[64] = {};
+        size_type fill = 0;
+        base_ptr cur = node_->next;
+        base_ptr carry = nullptr;
+        try {
+            while (cur != node_) {
+                carry = cur;
+                cur = cur->next;
+                carry->next = nullptr;
+                size_type i = 0;
+                for (; i < fill && bins[i] != nullptr; ++i) {
+                    auto later = carry;
+                    carry = nullptr;
+                    merge_chains(bins[i], later, comp);
+                    carry = bins[i];
+                    bins[i] = nullptr;
+                }
+                bins[i] = carry;
+                carry = nullptr;
+                if (i == fill) {
+                    ++fill;
+                }
+            }
+            for (size_type i = 1; i < fill; ++i) {
+                auto later = bins[i - 1];
+                bins[i - 1] = nullptr;
+                merge_chains(bins[i], later, comp);
+            }
+        } catch (...) {
+            // 还没有取下的[cur, node_)仍然是双向连接的，其余的链依次接在后面
+            if (cur != node_) {
+                node_->next = cur;
+                cur->prev = node_;
+            } else {
+                node_->unlink();
+            }
+            link_chain_at_back(carry);
+            for (size_type i = 0; i < fill; ++i) {
+                link_chain_at_back(bins[i]);
+            }
+            throw;
+        }
+        node_->unlink();
+        link_chain_at_back(bins[fill - 1]);
+    }
+
+// ***************
+// unique 删除相邻的重复元素
+// ***************
+    template<class T, class Alloc>
+    template<class BinaryPredicate>
+    typename list<T, Alloc>::size_type list<T, Alloc>::unique(BinaryPredicate pred) {
+        size_type removed = 0;
+        if (node_->next == node_) {
+            return removed;
+        }
+        auto i = node_->next;
+        auto j = i->next;
+        while (j != node_) {
+            auto next = j->next;
+            if (pred(i->as_node()->value, j->as_node()->value)) {
+                unlink_nodes(j, j);
+                destroy_node(j->as_node());
+                --size_;
+                ++removed;
+            } else {
+                i = j;
+            }
+            j = next;
+        }
+        return removed;
+    }
+
+// ***************
+// remove_if 删除满足pred的元素
+// ***************
+    /*
+     * 满足条件的节点先断开，用next串成单向链，遍历结束之后再统一销毁，
+     * 所以 remove(*it) 这样引用list中元素的写法也是安全的
+     */
+    template<class T, class Alloc>
+    template<class UnaryPredicate>
+    typename list<T, Alloc>::size_type list<T, Alloc>::remove_if(UnaryPredicate pred) {
+        base_ptr removed = nullptr;
+        size_type n = 0;
+        try {
+            for (auto cur = node_->next; cur != node_;) {
+                auto next = cur->next;
+                if (pred(cur->as_node()->value)) {
+                    unlink_nodes(cur, cur);
+                    cur->next = removed;
+                    removed = cur;
+                    --size_;
+                    ++n;
+                }
+                cur = next;
+            }
+        } catch (...) {
+            destroy_chain(removed);
+            throw;
+        }
+        destroy_chain(removed);
+        return n;
+    }
+
+// ***************
+// release 销毁所有节点，并释放头节点
+// ***************
+    template<class T, class Alloc>
+    void list<T, Alloc>::release() {
+        if (node_ != nullptr) {
+            if (alloc_traits::can_skip_destroy) {
+                node_ = nullptr;
+                size_ = 0;
+                return;
+            }
+            clear();
+            base_alloc().deallocate(node_, 1);
+            node_ = nullptr;
+        }
+    }
+
 // ***************
 // clear 清空list
 // ***************
-    template<class T>
-    void list<T>::clear() {
+    template<class T, class Alloc>
+    void list<T, Alloc>::clear() {
+        if (alloc_traits::can_skip_destroy) {
+            // 节点的内存由 arena 之类的分配器统一回收，不需要逐个遍历销毁
+            node_->unlink();
+            size_ = 0;
+            return;
+        }
         if (size_ != 0) {
             auto cur = node_->next;
             for (base_ptr next = cur->next; cur != node_; cur = next, next = cur->next) {
                 destroy_node(cur->as_node());
             }
             node_->unlink();
-            size_ - 0;
+            size_ = 0;
         }
     }
 
 // ***************
 // destroy_node 销毁节点
 // ***************
-    template<class T>
-    void list<T>::destroy_node(node_ptr p) {
-        data_allocator::destroy(mystl::address_of(p->value));
-        node_allocator::deallocate(p);
+    template<class T, class Alloc>
+    void list<T, Alloc>::destroy_node(node_ptr p) {
+        data_alloc().destroy(mystl::address_of(p->value));
+        node_alloc().deallocate(p);
     }
 
 // ***************
@@ -761,14 +1208,14 @@ namespace mystl {
      * 返回r
      * */
 
-    template<class T>
+    template<class T, class Alloc>
     template<class iter>
-    typename list<T>::iterator list<T>::copy_insert(const_iterator pos, size_type n, iter first) {
+    typename list<T, Alloc>::iterator list<T, Alloc>::copy_insert(const_iterator pos, size_type n, iter first) {
         iterator r(pos.node_);
         if (n != 0) {
             const auto add_size = n;
             auto node = create_node(*first);
-            r = iterator(node);
+            r = make_iter(node);
             iterator end = r;
             try {
                 for (--n, ++first; n > 0; --n, ++first, ++end) {
@@ -789,23 +1236,24 @@ namespace mystl {
 // ***************
 // erase 把pos处的删除,返回下一个迭代器
 // ***************
-    template<class T>
-    typename list<T>::iterator list<T>::erase(const_iterator pos) {
+    template<class T, class Alloc>
+    typename list<T, Alloc>::iterator list<T, Alloc>::erase(const_iterator pos) {
+        MYSTL_HARDENING_ASSERT(pos.node_ != node_, "list::erase(end())");
         auto n = pos.node_;
         auto next = n->next;
         unlink_nodes(n, n);// 把n这个节点给断开，unlink_nodes已经把前后连接起来
         destroy_node(n->as_node()); // 去除掉
         --size_;
-        return iterator(next);
+        return make_iter(next);
     }
 
 // ***************
 // erase 把[first,second)之间删除
 // ***************
-    template<class T>
-    typename list<T>::iterator list<T>::erase(const_iterator first, const_iterator second) {
+    template<class T, class Alloc>
+    typename list<T, Alloc>::iterator list<T, Alloc>::erase(const_iterator first, const_iterator second) {
         if (first != second) {
-            unlink_nodes(first, second.node_->prev); // 先断开连接
+            unlink_nodes(first.node_, second.node_->prev); // 先断开连接
             while (first != second) {
                 // 再挨着摧毁
                 auto cur = first.node_;
@@ -814,8 +1262,15 @@ namespace mystl {
                 --size_;
             }
         }
-        return iterator(second.node_);
+        return make_iter(second.node_);
     }
-}
 
+    // 使用多态内存资源的list，polymorphic_allocator 定义在 memory_resource.h 中，使用时需要包含它
+    namespace pmr {
+        template<class T>
+        class polymorphic_allocator;
 
+        template<class T>
+        using list = mystl::list<T, polymorphic_allocator<T>>;
+    }
+}
@@ -0,0 +1,682 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_MEMORY_RESOURCE_H
+#define STL_MEMORY_RESOURCE_H
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#include "allocator.h"
+#include "construct.h"
+#include "utils.h"
+
+// 这个头文件包含多态内存资源（pmr）：抽象基类 memory_resource、分配器 polymorphic_allocator，
+// 以及标准中的几种资源 new_delete_resource、null_memory_resource、monotonic_buffer_resource、
+// unsynchronized_pool_resource、synchronized_pool_resource
+// 容器的类型只和 polymorphic_allocator 有关，内存策略在运行时通过传入不同的资源选择，
+// mystl::pmr::vector / list / deque 的别名分别声明在各自的头文件中
+
+namespace mystl
+{
+namespace pmr
+{
+    /*****************************************************************************************/
+    // memory_resource
+    /*****************************************************************************************/
+    class memory_resource
+    {
+    public:
+        virtual ~memory_resource() = default;
+
+        void* allocate(size_t bytes, size_t align = alignof(std::max_align_t))
+        {
+            return do_allocate(bytes, align);
+        }
+
+        // bytes 和 align 必须和 allocate 时一致
+        void deallocate(void* ptr, size_t bytes, size_t align = alignof(std::max_align_t))
+        {
+            do_deallocate(ptr, bytes, align);
+        }
+
+        // 能否互相释放对方分配的内存
+        bool is_equal(const memory_resource& other) const noexcept
+        {
+            return do_is_equal(other);
+        }
+
+    private:
+        virtual void* do_allocate(size_t bytes, size_t align) = 0;
+
+        virtual void do_deallocate(void* ptr, size_t bytes, size_t align) = 0;
+
+        virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+    };
+
+    inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+    {
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+
+    inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /*****************************************************************************************/
+    // new_delete_resource / null_memory_resource
+    /*****************************************************************************************/
+    class new_delete_memory_resource : public memory_resource
+    {
+    private:
+        void* do_allocate(size_t bytes, size_t align) override
+        {
+            return mystl::aligned_allocate(bytes, align);
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t align) override
+        {
+            mystl::aligned_deallocate(ptr, bytes, align);
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    // 任何分配都抛出 bad_alloc，用来保证某段代码不会分配内存（比如作为 monotonic_buffer_resource 的上游）
+    class null_memory_resource_impl : public memory_resource
+    {
+    private:
+        void* do_allocate(size_t, size_t) override
+        {
+            throw std::bad_alloc();
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    // 两个资源故意不析构，静态存储期的容器在程序退出时仍然可以使用
+    inline memory_resource* new_delete_resource() noexcept
+    {
+        static memory_resource* r = new new_delete_memory_resource();
+        return r;
+    }
+
+    inline memory_resource* null_memory_resource() noexcept
+    {
+        static memory_resource* r = new null_memory_resource_impl();
+        return r;
+    }
+
+    inline std::atomic<memory_resource*>& default_resource_slot() noexcept
+    {
+        static std::atomic<memory_resource*> slot{new_delete_resource()};
+        return slot;
+    }
+
+    // 默认构造的 polymorphic_allocator 使用的资源，初始为 new_delete_resource
+    inline memory_resource* get_default_resource() noexcept
+    {
+        return default_resource_slot().load(std::memory_order_acquire);
+    }
+
+    // 设置默认资源，返回原来的资源，传入 nullptr 时恢复为 new_delete_resource
+    inline memory_resource* set_default_resource(memory_resource* r) noexcept
+    {
+        return default_resource_slot().exchange(r != nullptr ? r : new_delete_resource(),
+                                                std::memory_order_acq_rel);
+    }
+
+    /*****************************************************************************************/
+    // monotonic_buffer_resource
+    // 单调增长，从当前块中移动指针来分配，deallocate 什么都不做，release 或析构时把所有的块还给上游
+    // 可以先使用调用者提供的初始缓冲区（比如栈上的数组），用完之后再向上游申请，块大小翻倍增长
+    /*****************************************************************************************/
+    class monotonic_buffer_resource : public memory_resource
+    {
+    public:
+        enum { DEFAULT_BLOCK = 1024 };
+
+    private:
+        struct block_header
+        {
+            block_header* next;
+            size_t        size;  // 整块的字节数，包括头部
+        };
+
+        static constexpr size_t header_size =
+                (sizeof(block_header) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+        memory_resource* upstream_;
+        block_header*    blocks_;
+        char*            cur_;
+        char*            end_;
+        void*            initial_buffer_;
+        size_t           initial_size_;
+        size_t           next_size_;
+
+    public:
+        explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource()) noexcept
+                : monotonic_buffer_resource(nullptr, 0, DEFAULT_BLOCK, upstream) {}
+
+        explicit monotonic_buffer_resource(size_t initial_size,
+                                           memory_resource* upstream = get_default_resource()) noexcept
+                : monotonic_buffer_resource(nullptr, 0, initial_size, upstream) {}
+
+        monotonic_buffer_resource(void* buffer, size_t buffer_size,
+                                  memory_resource* upstream = get_default_resource()) noexcept
+                : monotonic_buffer_resource(buffer, buffer_size, buffer_size * 2, upstream) {}
+
+        monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+        monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+        ~monotonic_buffer_resource() override
+        {
+            release();
+        }
+
+        // 把所有的块还给上游，重新从初始缓冲区开始
+        void release() noexcept
+        {
+            while (blocks_ != nullptr)
+            {
+                block_header* next = blocks_->next;
+                upstream_->deallocate(blocks_, blocks_->size, alignof(std::max_align_t));
+                blocks_ = next;
+            }
+            cur_ = static_cast<char*>(initial_buffer_);
+            end_ = cur_ == nullptr ? nullptr : cur_ + initial_size_;
+        }
+
+        memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+    private:
+        monotonic_buffer_resource(void* buffer, size_t buffer_size, size_t next_size,
+                                  memory_resource* upstream) noexcept
+                : upstream_(upstream), blocks_(nullptr),
+                  cur_(static_cast<char*>(buffer)), end_(buffer == nullptr ? nullptr : cur_ + buffer_size),
+                  initial_buffer_(buffer), initial_size_(buffer_size),
+                  next_size_(next_size < header_size * 2 ? header_size * 2 : next_size) {}
+
+        static char* align_up(char* p, size_t align) noexcept
+        {
+            const auto v = reinterpret_cast<uintptr_t>(p);
+            return reinterpret_cast<char*>((v + align - 1) & ~(static_cast<uintptr_t>(align) - 1));
+        }
+
+        void* do_allocate(size_t bytes, size_t align) override
+        {
+            char* p = align_up(cur_, align);
+            if (cur_ == nullptr || p + bytes > end_)
+            {
+                new_block(bytes + align);
+                p = align_up(cur_, align);
+            }
+            cur_ = p + bytes;
+            return p;
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        void new_block(size_t min_bytes)
+        {
+            size_t size = next_size_;
+            if (size < min_bytes + header_size)
+            {
+                size = min_bytes + header_size;
+            }
+            auto block = static_cast<block_header*>(upstream_->allocate(size, alignof(std::max_align_t)));
+            block->next = blocks_;
+            block->size = size;
+            blocks_ = block;
+            cur_ = reinterpret_cast<char*>(block) + header_size;
+            end_ = reinterpret_cast<char*>(block) + size;
+            next_size_ *= 2;
+        }
+    };
+
+    /*****************************************************************************************/
+    // unsynchronized_pool_resource
+    // 按 2 的幂划分大小类，每个大小类一个池，池中是同样大小的块组成的自由链表，链表为空时向上游申请一个 chunk 切分
+    // chunk 中的块数从 MIN_BLOCKS 开始翻倍，直到 max_blocks_per_chunk，超过 largest_required_pool_block 的请求直接交给上游
+    // 不是线程安全的，多个线程共享时使用 synchronized_pool_resource
+    /*****************************************************************************************/
+    struct pool_options
+    {
+        size_t max_blocks_per_chunk = 0;          // 0 表示使用默认值
+        size_t largest_required_pool_block = 0;   // 0 表示使用默认值
+    };
+
+    class unsynchronized_pool_resource : public memory_resource
+    {
+    public:
+        enum { MIN_BLOCK = 8 };
+        enum { MIN_BLOCKS = 16 };
+        enum { DEFAULT_MAX_BLOCKS = 1024 };
+        enum { DEFAULT_LARGEST_BLOCK = 4096 };
+        enum { MAX_POOLS = 20 };
+
+    private:
+        union free_block
+        {
+            free_block* next;
+            char        data[1];
+        };
+
+        // 向上游申请的 chunk 的记录，release 时用于归还
+        struct chunk_record
+        {
+            chunk_record* next;
+            void*         ptr;
+            size_t        bytes;
+            size_t        align;
+        };
+
+        struct pool
+        {
+            free_block*   free_list = nullptr;
+            chunk_record* chunks = nullptr;
+            size_t        next_blocks = MIN_BLOCKS;
+        };
+
+        // 直接交给上游的大块，前面有一个头部，串成双向链表
+        struct large_header
+        {
+            large_header* prev;
+            large_header* next;
+            size_t        bytes;   // 向上游申请的字节数，包括头部
+            size_t        align;
+        };
+
+        memory_resource* upstream_;
+        pool_options     options_;
+        pool             pools_[MAX_POOLS];
+        size_t           npools_;
+        large_header*    large_;
+
+    public:
+        explicit unsynchronized_pool_resource(memory_resource* upstream = get_default_resource()) noexcept
+                : unsynchronized_pool_resource(pool_options(), upstream) {}
+
+        unsynchronized_pool_resource(const pool_options& opts,
+                                     memory_resource* upstream = get_default_resource()) noexcept
+                : upstream_(upstream), options_(normalize(opts)), npools_(0), large_(nullptr)
+        {
+            for (size_t block = MIN_BLOCK; block <= options_.largest_required_pool_block; block <<= 1)
+            {
+                ++npools_;
+            }
+        }
+
+        unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+        unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+        ~unsynchronized_pool_resource() override
+        {
+            release();
+        }
+
+        // 把所有的内存还给上游，包括还没有释放的块
+        void release() noexcept
+        {
+            for (size_t i = 0; i < npools_; ++i)
+            {
+                pool& p = pools_[i];
+                while (p.chunks != nullptr)
+                {
+                    chunk_record* next = p.chunks->next;
+                    upstream_->deallocate(p.chunks->ptr, p.chunks->bytes, p.chunks->align);
+                    upstream_->deallocate(p.chunks, sizeof(chunk_record), alignof(chunk_record));
+                    p.chunks = next;
+                }
+                p.free_list = nullptr;
+                p.next_blocks = MIN_BLOCKS;
+            }
+            while (large_ != nullptr)
+            {
+                large_header* next = large_->next;
+                const size_t head = large_header_size(large_->align);
+                upstream_->deallocate(reinterpret_cast<char*>(large_ + 1) - head, large_->bytes, large_->align);
+                large_ = next;
+            }
+        }
+
+        memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+        pool_options options() const noexcept { return options_; }
+
+    private:
+        static pool_options normalize(pool_options opts) noexcept
+        {
+            if (opts.max_blocks_per_chunk == 0 || opts.max_blocks_per_chunk > static_cast<size_t>(DEFAULT_MAX_BLOCKS))
+            {
+                opts.max_blocks_per_chunk = DEFAULT_MAX_BLOCKS;
+            }
+            if (opts.max_blocks_per_chunk < static_cast<size_t>(MIN_BLOCKS))
+            {
+                opts.max_blocks_per_chunk = MIN_BLOCKS;
+            }
+            if (opts.largest_required_pool_block == 0)
+            {
+                opts.largest_required_pool_block = DEFAULT_LARGEST_BLOCK;
+            }
+            // 上调到 2 的幂，并限制池的个数
+            size_t block = MIN_BLOCK;
+            size_t n = 1;
+            while (block < opts.largest_required_pool_block && n < static_cast<size_t>(MAX_POOLS))
+            {
+                block <<= 1;
+                ++n;
+            }
+            opts.largest_required_pool_block = block;
+            return opts;
+        }
+
+        // 块的大小为 max(bytes, align) 上调到 2 的幂，同一个池中的块都按块大小对齐，所以满足 align
+        static size_t block_size(size_t bytes, size_t align) noexcept
+        {
+            size_t need = bytes < align ? align : bytes;
+            size_t block = MIN_BLOCK;
+            while (block < need)
+            {
+                block <<= 1;
+            }
+            return block;
+        }
+
+        static size_t pool_index(size_t block) noexcept
+        {
+            size_t i = 0;
+            for (size_t b = MIN_BLOCK; b < block; b <<= 1)
+            {
+                ++i;
+            }
+            return i;
+        }
+
+        static size_t large_header_size(size_t align) noexcept
+        {
+            const size_t a = align < alignof(std::max_align_t) ? alignof(std::max_align_t) : align;
+            return (sizeof(large_header) + a - 1) & ~(a - 1);
+        }
+
+        void* do_allocate(size_t bytes, size_t align) override
+        {
+            const size_t block = block_size(bytes, align);
+            if (block > options_.largest_required_pool_block)
+            {
+                return allocate_large(bytes, align);
+            }
+            pool& p = pools_[pool_index(block)];
+            if (p.free_list == nullptr)
+            {
+                refill(p, block);
+            }
+            free_block* result = p.free_list;
+            p.free_list = result->next;
+            return result;
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t align) override
+        {
+            const size_t block = block_size(bytes, align);
+            if (block > options_.largest_required_pool_block)
+            {
+                deallocate_large(ptr, bytes, align);
+                return;
+            }
+            pool& p = pools_[pool_index(block)];
+            auto q = static_cast<free_block*>(ptr);
+            q->next = p.free_list;
+            p.free_list = q;
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        // 向上游申请一个 chunk，切分成 next_blocks 个块挂到自由链表上
+        void refill(pool& p, size_t block)
+        {
+            const size_t nblocks = p.next_blocks;
+            const size_t bytes = block * nblocks;
+            auto record = static_cast<chunk_record*>(upstream_->allocate(sizeof(chunk_record), alignof(chunk_record)));
+            char* chunk = nullptr;
+            try
+            {
+                chunk = static_cast<char*>(upstream_->allocate(bytes, block));
+            }
+            catch (...)
+            {
+                upstream_->deallocate(record, sizeof(chunk_record), alignof(chunk_record));
+                throw;
+            }
+            record->next = p.chunks;
+            record->ptr = chunk;
+            record->bytes = bytes;
+            record->align = block;
+            p.chunks = record;
+            for (size_t i = nblocks; i > 0; --i)
+            {
+                auto q = reinterpret_cast<free_block*>(chunk + (i - 1) * block);
+                q->next = p.free_list;
+                p.free_list = q;
+            }
+            if (p.next_blocks < options_.max_blocks_per_chunk)
+            {
+                p.next_blocks *= 2;
+            }
+        }
+
+        void* allocate_large(size_t bytes, size_t align)
+        {
+            const size_t head = large_header_size(align);
+            char* raw = static_cast<char*>(upstream_->allocate(bytes + head, align));
+            auto h = reinterpret_cast<large_header*>(raw + head - sizeof(large_header));
+            h->prev = nullptr;
+            h->next = large_;
+            h->bytes = bytes + head;
+            h->align = align;
+            if (large_ != nullptr)
+            {
+                large_->prev = h;
+            }
+            large_ = h;
+            return raw + head;
+        }
+
+        void deallocate_large(void* ptr, size_t, size_t align)
+        {
+            const size_t head = large_header_size(align);
+            char* raw = static_cast<char*>(ptr) - head;
+            auto h = reinterpret_cast<large_header*>(raw + head - sizeof(large_header));
+            if (h->prev != nullptr)
+            {
+                h->prev->next = h->next;
+            }
+            else
+            {
+                large_ = h->next;
+            }
+            if (h->next != nullptr)
+            {
+                h->next->prev = h->prev;
+            }
+            upstream_->deallocate(raw, h->bytes, align);
+        }
+    };
+
+    /*****************************************************************************************/
+    // synchronized_pool_resource
+    // 和 unsynchronized_pool_resource 一样，每次操作加锁，可以被多个线程共享
+    /*****************************************************************************************/
+    class synchronized_pool_resource : public memory_resource
+    {
+    private:
+        mutable std::mutex           lock_;
+        unsynchronized_pool_resource impl_;
+
+    public:
+        explicit synchronized_pool_resource(memory_resource* upstream = get_default_resource()) noexcept
+                : impl_(upstream) {}
+
+        synchronized_pool_resource(const pool_options& opts,
+                                   memory_resource* upstream = get_default_resource()) noexcept
+                : impl_(opts, upstream) {}
+
+        synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+        synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+        void release()
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            impl_.release();
+        }
+
+        memory_resource* upstream_resource() const noexcept { return impl_.upstream_resource(); }
+
+        pool_options options() const noexcept { return impl_.options(); }
+
+    private:
+        void* do_allocate(size_t bytes, size_t align) override
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            return impl_.allocate(bytes, align);
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t align) override
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            impl_.deallocate(ptr, bytes, align);
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    /*****************************************************************************************/
+    // polymorphic_allocator
+    // 保存 memory_resource 的指针，拷贝、rebind 之后仍然指向同一个资源
+    // 和标准一致，拷贝、移动、交换容器时不传播，拷贝构造容器时使用默认资源
+    /*****************************************************************************************/
+    template <class T>
+    class polymorphic_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef polymorphic_allocator<U> other;
+        };
+
+    private:
+        memory_resource* resource_;
+
+    public:
+        polymorphic_allocator() noexcept : resource_(get_default_resource()) {}
+
+        // 可以从 memory_resource* 隐式转换，容器的构造函数可以直接传入资源的地址
+        polymorphic_allocator(memory_resource* r) noexcept : resource_(r) {}
+
+        template <class U>
+        polymorphic_allocator(const polymorphic_allocator<U>& rhs) noexcept : resource_(rhs.resource()) {}
+
+        polymorphic_allocator& operator=(const polymorphic_allocator&) = default;
+
+        memory_resource* resource() const noexcept { return resource_; }
+
+        T* allocate()
+        {
+            return allocate(1);
+        }
+
+        T* allocate(size_type n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* ptr)
+        {
+            deallocate(ptr, 1);
+        }
+
+        // n 必须和 allocate 时一致
+        void deallocate(T* ptr, size_type n)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+            resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        template <class... Args>
+        void construct(T* ptr, Args&&... args)
+        {
+            mystl::construct(ptr, mystl::forward<Args>(args)...);
+        }
+
+        void destroy(T* ptr)
+        {
+            mystl::destroy(ptr);
+        }
+
+        void destroy(T* first, T* last)
+        {
+            mystl::destroy(first, last);
+        }
+
+        polymorphic_allocator select_on_container_copy_construction() const
+        {
+            return polymorphic_allocator();
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept
+    {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+    template <class T, class U>
+    bool operator!=(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+} // namespace pmr
+}
+
+#endif //STL_MEMORY_RESOURCE_H
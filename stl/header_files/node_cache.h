@@ -0,0 +1,337 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_NODE_CACHE_H
+#define STL_NODE_CACHE_H
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "utils.h"
+
+// 这个头文件包含节点分配的线程本地缓存 magazine_allocator，主要给 list 的节点使用
+// 每个线程持有两个弹匣（magazine），每个弹匣最多放 MAG_ROUNDS 个空闲节点，allocate/deallocate 只操作本线程的弹匣，
+// 两个弹匣都空（或都满）时才加锁，和全局仓库（depot）整个交换一个弹匣，所以稳态下不会碰到全局锁
+// 一个线程释放另一个线程分配的节点时，节点直接进入释放线程的弹匣，之后可以被任何线程重新使用
+// 节点的内存按弹匣大小成批（slab）申请，不还给系统，线程退出时它的弹匣会归还给仓库
+
+#ifndef MYSTL_MAGAZINE_ROUNDS
+#define MYSTL_MAGAZINE_ROUNDS 32
+#endif
+
+namespace mystl
+{
+    /*****************************************************************************************/
+    // magazine_cache
+    // 大小为 Size、对齐为 Align 的节点的缓存，相同大小的类型共享同一个
+    /*****************************************************************************************/
+    template <size_t Size, size_t Align>
+    class magazine_cache
+    {
+        static_assert(Size % Align == 0 && Size >= sizeof(void*), "bad node size");
+
+    public:
+        enum { MAG_ROUNDS = MYSTL_MAGAZINE_ROUNDS };
+
+    private:
+        struct magazine
+        {
+            magazine* next;
+            size_t    rounds;              // 当前弹匣中的空闲节点数目
+            void*     round[MAG_ROUNDS];
+        };
+
+        // 全局仓库，保存满的和空的弹匣，只有交换弹匣时才加锁
+        struct depot
+        {
+            std::mutex lock;
+            magazine*  full = nullptr;
+            magazine*  empty = nullptr;
+        };
+
+        // 线程本地的缓存，必须是平凡析构的，这样线程退出的过程中（guard 析构之后）仍然可以安全地访问
+        struct thread_cache
+        {
+            magazine* loaded;
+            magazine* previous;
+            bool      dead;      // 已经归还给仓库，之后的请求直接走仓库
+        };
+
+        // 线程退出时把弹匣归还给仓库
+        struct cache_guard
+        {
+            ~cache_guard()
+            {
+                thread_cache& tc = local();
+                depot& d = get_depot();
+                std::lock_guard<std::mutex> guard(d.lock);
+                give_back(d, tc.loaded);
+                give_back(d, tc.previous);
+                tc.loaded = tc.previous = nullptr;
+                tc.dead = true;
+            }
+        };
+
+        // 仓库故意不析构，静态存储期的容器在程序退出时仍然可以释放节点
+        static depot& get_depot()
+        {
+            static depot* d = new depot();
+            return *d;
+        }
+
+        static thread_cache& local() noexcept
+        {
+            static thread_local thread_cache tc{nullptr, nullptr, false};
+            return tc;
+        }
+
+        static thread_cache& local_guarded()
+        {
+            static thread_local cache_guard guard;
+            (void)guard;
+            return local();
+        }
+
+        static void give_back(depot& d, magazine* m) noexcept
+        {
+            if (m == nullptr)
+            {
+                return;
+            }
+            magazine*& head = m->rounds == 0 ? d.empty : d.full;
+            m->next = head;
+            head = m;
+        }
+
+        static magazine* new_magazine()
+        {
+            auto m = static_cast<magazine*>(::operator new(sizeof(magazine)));
+            m->next = nullptr;
+            m->rounds = 0;
+            return m;
+        }
+
+        // 一次申请 MAG_ROUNDS 个节点的连续内存，装满弹匣 m
+        static void fill_from_slab(magazine* m)
+        {
+            char* slab = static_cast<char*>(mystl::aligned_allocate(Size * MAG_ROUNDS, Align));
+            for (size_t i = 0; i < static_cast<size_t>(MAG_ROUNDS); ++i)
+            {
+                m->round[i] = slab + Size * (MAG_ROUNDS - 1 - i);
+            }
+            m->rounds = MAG_ROUNDS;
+        }
+
+        // 本线程两个弹匣都空：把空弹匣还给仓库，换一个满的回来，仓库没有满弹匣时从 slab 装满
+        static void refill(thread_cache& tc)
+        {
+            depot& d = get_depot();
+            {
+                std::lock_guard<std::mutex> guard(d.lock);
+                if (d.full != nullptr)
+                {
+                    magazine* m = d.full;
+                    d.full = m->next;
+                    give_back(d, tc.loaded);
+                    tc.loaded = m;
+                    return;
+                }
+            }
+            if (tc.loaded == nullptr)
+            {
+                tc.loaded = new_magazine();
+            }
+            fill_from_slab(tc.loaded);
+        }
+
+        // 本线程两个弹匣都满：把 previous 交给仓库，loaded 变成 previous，再拿一个空弹匣
+        static void flush(thread_cache& tc)
+        {
+            depot& d = get_depot();
+            magazine* m = nullptr;
+            {
+                std::lock_guard<std::mutex> guard(d.lock);
+                give_back(d, tc.previous);
+                if (d.empty != nullptr)
+                {
+                    m = d.empty;
+                    d.empty = m->next;
+                }
+            }
+            tc.previous = tc.loaded;
+            tc.loaded = m != nullptr ? m : new_magazine();
+        }
+
+    public:
+        static void* allocate()
+        {
+            thread_cache& tc = local_guarded();
+            if (tc.dead)
+            {
+                return mystl::aligned_allocate(Size, Align);
+            }
+            if (tc.loaded == nullptr || tc.loaded->rounds == 0)
+            {
+                if (tc.previous != nullptr && tc.previous->rounds != 0)
+                {
+                    mystl::swap(tc.loaded, tc.previous);
+                }
+                else
+                {
+                    refill(tc);
+                }
+            }
+            return tc.loaded->round[--tc.loaded->rounds];
+        }
+
+        static void deallocate(void* ptr)
+        {
+            thread_cache& tc = local();
+            if (tc.dead)
+            {
+                // 线程已经在退出，节点直接放进仓库中一个空弹匣
+                depot& d = get_depot();
+                std::lock_guard<std::mutex> guard(d.lock);
+                magazine* m = d.empty != nullptr ? d.empty : new_magazine();
+                if (m == d.empty)
+                {
+                    d.empty = m->next;
+                }
+                m->round[0] = ptr;
+                m->rounds = 1;
+                give_back(d, m);
+                return;
+            }
+            if (tc.loaded == nullptr || tc.loaded->rounds == static_cast<size_t>(MAG_ROUNDS))
+            {
+                if (tc.previous != nullptr && tc.previous->rounds != static_cast<size_t>(MAG_ROUNDS))
+                {
+                    mystl::swap(tc.loaded, tc.previous);
+                }
+                else if (tc.loaded == nullptr)
+                {
+                    local_guarded();
+                    tc.loaded = new_magazine();
+                }
+                else
+                {
+                    flush(tc);
+                }
+            }
+            tc.loaded->round[tc.loaded->rounds++] = ptr;
+        }
+    };
+
+    /*****************************************************************************************/
+    // magazine_allocator
+    // 单个对象的分配走线程本地缓存，一次分配多个对象时直接交给 aligned_allocate
+    // 所以适合 list 这种一次只分配一个节点的容器：mystl::list<T, mystl::magazine_allocator<T>>
+    /*****************************************************************************************/
+    template <class T>
+    class magazine_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef magazine_allocator<U> other;
+        };
+
+    private:
+        // 节点大小上调到对齐的倍数，并且至少能放下一个指针
+        static constexpr size_t node_align = alignof(T) < alignof(void*) ? alignof(void*) : alignof(T);
+        static constexpr size_t node_size = (sizeof(T) + node_align - 1) & ~(node_align - 1);
+
+        typedef magazine_cache<node_size, node_align> cache;
+
+    public:
+        magazine_allocator() noexcept = default;
+
+        template <class U>
+        magazine_allocator(const magazine_allocator<U>&) noexcept {}
+
+        static T* allocate()
+        {
+            return static_cast<T*>(cache::allocate());
+        }
+
+        static T* allocate(size_type n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            if (n == 1)
+            {
+                return allocate();
+            }
+            return static_cast<T*>(mystl::aligned_allocate(n * sizeof(T), node_align));
+        }
+
+        static void deallocate(T* ptr)
+        {
+            deallocate(ptr, 1);
+        }
+
+        // n 必须和 allocate 时一致
+        static void deallocate(T* ptr, size_type n)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+            if (n == 1)
+            {
+                cache::deallocate(ptr);
+            }
+            else
+            {
+                mystl::aligned_deallocate(ptr, n * sizeof(T), node_align);
+            }
+        }
+
+        template <class... Args>
+        static void construct(T* ptr, Args&&... args)
+        {
+            mystl::construct(ptr, mystl::forward<Args>(args)...);
+        }
+
+        static void destroy(T* ptr)
+        {
+            mystl::destroy(ptr);
+        }
+
+        static void destroy(T* first, T* last)
+        {
+            mystl::destroy(first, last);
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const magazine_allocator<T>&, const magazine_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const magazine_allocator<T>&, const magazine_allocator<U>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif //STL_NODE_CACHE_H
@@ -0,0 +1,317 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_NUMA_ALLOCATOR_H
+#define STL_NUMA_ALLOCATOR_H
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <new>
+
+#include "allocator.h"
+#include "construct.h"
+#include "utils.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// 这个头文件包含按 NUMA 策略分配内存的 numa_allocator，可以用于 vector 的存储和 deque 的缓冲区
+// 策略有三种：local（分配在访问线程所在的节点）、interleave（按页轮流分布在所有节点上）、bind（只分配在指定节点）
+// 不小于 MYSTL_NUMA_THRESHOLD 字节的请求用 mmap 映射，再用 mbind 系统调用设置策略（不依赖 libnuma），
+// 更小的请求和 allocator 一样，因为策略只能以页为单位设置
+// 阈值默认是半页（2 KiB），deque 的缓冲区（4096 / sizeof(T) 个元素，不少于 3841 字节；或者 16 个大元素）也会映射，
+// 代价是每个缓冲区都要 mmap、mbind 和 munmap 三次系统调用，并且至少占用一整页；
+// 内核会合并相邻的、策略相同的映射，但缓冲区不相邻时每个缓冲区占用一个映射，受 vm.max_map_count 限制
+// 主要用于大的 vector 时可以定义更大的 MYSTL_NUMA_THRESHOLD，小的请求就不再有系统调用的开销
+// 内核不支持 mbind 或者只有一个节点时策略不起作用，退化为首次访问（first-touch）分配，
+// 这时可以定义 MYSTL_PARALLEL_FILL，让 uninitialized_fill_n 多线程初始化页面（见 uninitialized.h）
+
+#ifndef MYSTL_NUMA_THRESHOLD
+#define MYSTL_NUMA_THRESHOLD (2 * 1024)
+#endif
+
+namespace mystl
+{
+    enum class numa_policy
+    {
+        local,        // 访问线程所在的节点
+        interleave,   // 所有节点之间按页交错
+        bind          // 绑定到一个节点
+    };
+
+    /*****************************************************************************************/
+    // numa_impl
+    // 和类型无关的映射、设置策略、释放
+    /*****************************************************************************************/
+    class numa_impl
+    {
+    public:
+        // 内核中的策略编号（linux/mempolicy.h）
+        enum { MPOL_DEFAULT_ = 0, MPOL_PREFERRED_ = 1, MPOL_BIND_ = 2, MPOL_INTERLEAVE_ = 3, MPOL_LOCAL_ = 4 };
+
+        enum { MAX_NODES = 8 * sizeof(unsigned long) };  // 节点掩码只用一个 unsigned long
+
+        // 在线的节点数，从 /sys/devices/system/node/online 读取（形如 "0-1" 或 "0,2-3"），读取失败时为 1
+        static int node_count() noexcept
+        {
+            static const int count = read_node_count();
+            return count;
+        }
+
+        static size_t page_size() noexcept
+        {
+#if defined(__linux__)
+            static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            return size;
+#else
+            return 4096;
+#endif
+        }
+
+        static size_t map_length(size_t bytes) noexcept
+        {
+            const size_t page = page_size();
+            return (bytes + page - 1) & ~(page - 1);
+        }
+
+        static void* map(size_t bytes, numa_policy policy, int node)
+        {
+#if defined(__linux__)
+            const size_t len = map_length(bytes);
+            void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+            apply(p, len, policy, node);
+            return p;
+#else
+            (void)policy;
+            (void)node;
+            return mystl::aligned_allocate(map_length(bytes), page_size());
+#endif
+        }
+
+        static void unmap(void* ptr, size_t bytes) noexcept
+        {
+#if defined(__linux__)
+            ::munmap(ptr, map_length(bytes));
+#else
+            mystl::aligned_deallocate(ptr, map_length(bytes), page_size());
+#endif
+        }
+
+        // 给 [ptr, ptr + len) 设置策略，失败时（内核不支持、节点不存在、单节点）保持默认的首次访问分配
+        static bool apply(void* ptr, size_t len, numa_policy policy, int node) noexcept
+        {
+#if defined(__linux__) && defined(SYS_mbind)
+            const int nodes = node_count();
+            if (nodes <= 1)
+            {
+                return false;
+            }
+            unsigned long mask = 0;
+            int mode = MPOL_LOCAL_;
+            switch (policy)
+            {
+                case numa_policy::local:
+                    break;
+                case numa_policy::interleave:
+                    mode = MPOL_INTERLEAVE_;
+                    mask = nodes >= static_cast<int>(MAX_NODES) ? ~0UL : (1UL << nodes) - 1;
+                    break;
+                case numa_policy::bind:
+                    if (node < 0 || node >= static_cast<int>(MAX_NODES))
+                    {
+                        return false;
+                    }
+                    mode = MPOL_BIND_;
+                    mask = 1UL << node;
+                    break;
+            }
+            return ::syscall(SYS_mbind, ptr, len, mode, mask == 0 ? nullptr : &mask,
+                             mask == 0 ? 0UL : static_cast<unsigned long>(MAX_NODES) + 1, 0U) == 0;
+#else
+            (void)ptr;
+            (void)len;
+            (void)policy;
+            (void)node;
+            return false;
+#endif
+        }
+
+    private:
+        static int read_node_count() noexcept
+        {
+            std::FILE* f = std::fopen("/sys/devices/system/node/online", "r");
+            if (f == nullptr)
+            {
+                return 1;
+            }
+            int count = 0;
+            int first = 0;
+            int last = 0;
+            for (;;)
+            {
+                if (std::fscanf(f, "%d", &first) != 1)
+                {
+                    break;
+                }
+                last = first;
+                int c = std::fgetc(f);
+                if (c == '-')
+                {
+                    if (std::fscanf(f, "%d", &last) != 1)
+                    {
+                        break;
+                    }
+                    c = std::fgetc(f);
+                }
+                count += last - first + 1;
+                if (c != ',')
+                {
+                    break;
+                }
+            }
+            std::fclose(f);
+            return count > 0 ? count : 1;
+        }
+    };
+
+    /*****************************************************************************************/
+    // numa_allocator
+    // 有状态的分配器，保存策略和节点，rebind 之后保持不变
+    /*****************************************************************************************/
+    template <class T>
+    class numa_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef numa_allocator<U> other;
+        };
+
+        template <class U>
+        friend class numa_allocator;
+
+    private:
+        numa_policy policy_;
+        int         node_;
+
+        static bool use_map(size_type n) noexcept
+        {
+            return n * sizeof(T) >= static_cast<size_t>(MYSTL_NUMA_THRESHOLD);
+        }
+
+    public:
+        explicit numa_allocator(numa_policy policy = numa_policy::local, int node = 0) noexcept
+                : policy_(policy), node_(node) {}
+
+        template <class U>
+        numa_allocator(const numa_allocator<U>& rhs) noexcept : policy_(rhs.policy_), node_(rhs.node_) {}
+
+        numa_policy policy() const noexcept { return policy_; }
+
+        int node() const noexcept { return node_; }
+
+        T* allocate()
+        {
+            return allocate(1);
+        }
+
+        T* allocate(size_type n)
+        {
+            if (n == 0)
+            {
+                return nullptr;
+            }
+            if (use_map(n))
+            {
+                return static_cast<T*>(numa_impl::map(n * sizeof(T), policy_, node_));
+            }
+            return mystl::allocator<T>::allocate(n);
+        }
+
+        // 映射的请求上调到整页，不映射的请求和 allocator 一样
+        allocation_result<T*> allocate_at_least(size_type n)
+        {
+            if (!use_map(n))
+            {
+                // 上调之后的个数也不能越过阈值，否则释放时会按映射 munmap 掉 ::operator new 的内存，
+                // 可能越过时不上调，按请求的个数分配
+                if (mystl::malloc_good_size(n * sizeof(T)) >= static_cast<size_t>(MYSTL_NUMA_THRESHOLD))
+                {
+                    return {mystl::allocator<T>::allocate(n), n};
+                }
+                return mystl::allocator<T>::allocate_at_least(n);
+            }
+            const size_type count = numa_impl::map_length(n * sizeof(T)) / sizeof(T);
+            return {allocate(count), count};
+        }
+
+        void deallocate(T* ptr)
+        {
+            deallocate(ptr, 1);
+        }
+
+        // n 必须和 allocate 时一致，用它区分内存来自映射还是 ::operator new
+        void deallocate(T* ptr, size_type n)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+            if (use_map(n))
+            {
+                numa_impl::unmap(ptr, n * sizeof(T));
+                return;
+            }
+            mystl::allocator<T>::deallocate(ptr, n);
+        }
+
+        template <class... Args>
+        void construct(T* ptr, Args&&... args)
+        {
+            mystl::construct(ptr, mystl::forward<Args>(args)...);
+        }
+
+        void destroy(T* ptr)
+        {
+            mystl::destroy(ptr);
+        }
+
+        void destroy(T* first, T* last)
+        {
+            mystl::destroy(first, last);
+        }
+    };
+
+    // 释放只和大小有关，任意两个实例都可以释放对方分配的内存
+    template <class T, class U>
+    bool operator==(const numa_allocator<T>&, const numa_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const numa_allocator<T>&, const numa_allocator<U>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif //STL_NUMA_ALLOCATOR_H
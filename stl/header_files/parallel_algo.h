@@ -0,0 +1,389 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_PARALLEL_ALGO_H
+#define STL_PARALLEL_ALGO_H
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+
+#include "algorithm.h"
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "vector.h"
+
+// 这个头文件包含带执行策略的 sort 和 merge，第一个参数为 mystl::execution::seq 或 mystl::execution::par
+// par 默认使用 hardware_concurrency 个线程，par.with_threads(n) 指定线程数；
+// 元素个数小于 MYSTL_PARALLEL_SORT_THRESHOLD 或者只有一个线程时和 seq 一样使用顺序的版本
+//
+// sort：并行归并排序，先把区间分成 2、8、32 或 128 段（只由元素个数决定），各段并行 introsort，
+// 再逐轮两两归并，每次归并按 merge path 切成多份交给不同的线程，每轮都在原区间和一块同样大小的缓冲区之间交替，
+// 段数取 2 的奇数次幂，最后一轮正好写回原区间；分段和归并树都和线程数无关，归并是稳定的，
+// 所以对同样的输入，无论使用多少线程结果都完全相同
+// merge：按 merge path 把输出切成线程数份，每份独立地顺序归并，结果和顺序的 merge 相同（稳定）
+//
+// 只接受随机访问迭代器（vector、deque、原生指针），merge 的输出也要是随机访问迭代器
+// 和标准库的并行算法一样，比较函数、元素的移动在工作线程中抛出异常时调用 std::terminate
+// sort 的缓冲区和切分点表在开始之前分配，分配失败时退回顺序的版本；
+// 比较函数在调用线程中（计算切分点时）抛出异常时，缓冲区被释放，所有元素回到原区间（顺序不确定），异常传给调用者
+
+#ifndef MYSTL_PARALLEL_SORT_THRESHOLD
+#define MYSTL_PARALLEL_SORT_THRESHOLD (1 << 16)
+#endif
+
+namespace mystl
+{
+    namespace execution
+    {
+        // 顺序执行
+        struct sequenced_policy {};
+
+        // 多线程执行，threads 为 0 时使用 hardware_concurrency
+        struct parallel_policy
+        {
+            size_t threads;
+
+            constexpr parallel_policy() noexcept : threads(0) {}
+
+            constexpr explicit parallel_policy(size_t n) noexcept : threads(n) {}
+
+            constexpr parallel_policy with_threads(size_t n) const noexcept { return parallel_policy(n); }
+        };
+
+        constexpr sequenced_policy seq{};
+        constexpr parallel_policy  par{};
+    }
+
+    template <class T>
+    struct is_execution_policy : public std::false_type {};
+
+    template <>
+    struct is_execution_policy<execution::sequenced_policy> : public std::true_type {};
+
+    template <>
+    struct is_execution_policy<execution::parallel_policy> : public std::true_type {};
+
+    namespace parallel_detail
+    {
+        enum { MAX_THREADS = 256 };
+
+        constexpr size_t kMinLeaf   = 16384;  // 每段至少的元素个数
+        constexpr size_t kMaxLeaves = 128;    // 最多的段数
+
+        inline size_t thread_count(const execution::parallel_policy& policy) noexcept
+        {
+            size_t n = policy.threads != 0 ? policy.threads : std::thread::hardware_concurrency();
+            if (n == 0)
+            {
+                n = 1;
+            }
+            return n < static_cast<size_t>(MAX_THREADS) ? n : static_cast<size_t>(MAX_THREADS);
+        }
+
+        // 用 threads 个线程（包括当前线程）执行 fn(0) ... fn(tasks - 1)，线程按顺序领取任务，全部完成后返回
+        // 线程创建失败时由已经启动的线程（至少有当前线程）完成剩下的任务
+        template <class Fn>
+        void run_tasks(size_t tasks, size_t threads, Fn& fn)
+        {
+            if (threads > tasks)
+            {
+                threads = tasks;
+            }
+            std::atomic<size_t> next(0);
+            auto worker = [&fn, &next, tasks]() noexcept
+            {
+                for (size_t i = next.fetch_add(1); i < tasks; i = next.fetch_add(1))
+                {
+                    fn(i);
+                }
+            };
+            std::thread workers[MAX_THREADS];
+            size_t started = 0;
+            for (size_t t = 1; t < threads; ++t)
+            {
+                try
+                {
+                    workers[started] = std::thread(worker);
+                    ++started;
+                }
+                catch (...)
+                {
+                    break;
+                }
+            }
+            worker();
+            for (size_t i = 0; i < started; ++i)
+            {
+                workers[i].join();
+            }
+        }
+
+        // merge path：[a, a + n1) 和 [b, b + n2) 稳定归并之后的前 k 个元素中，有多少个来自 a
+        template <class Iter1, class Iter2, class Compared>
+        size_t co_rank(size_t k, Iter1 a, size_t n1, Iter2 b, size_t n2, Compared& comp)
+        {
+            size_t lo = k > n2 ? k - n2 : 0;
+            size_t hi = k < n1 ? k : n1;
+            while (lo < hi)
+            {
+                const size_t i = lo + (hi - lo) / 2;
+                const size_t j = k - i;
+                // 相等时 a 中的元素在前，a[i] 不大于 b[j - 1] 说明前 k 个中来自 a 的多于 i 个
+                if (j > 0 && !comp(*(b + (j - 1)), *(a + i)))
+                {
+                    lo = i + 1;
+                }
+                else
+                {
+                    hi = i;
+                }
+            }
+            return lo;
+        }
+
+        // 稳定归并，元素移动到 result，result 中的位置已经有构造好的元素
+        template <class Iter1, class Iter2, class OutIter, class Compared>
+        OutIter move_merge(Iter1 first1, Iter1 last1, Iter2 first2, Iter2 last2, OutIter result, Compared& comp)
+        {
+            while (first1 != last1 && first2 != last2)
+            {
+                if (comp(*first2, *first1))
+                {
+                    *result = mystl::move(*first2);
+                    ++first2;
+                }
+                else
+                {
+                    *result = mystl::move(*first1);
+                    ++first1;
+                }
+                ++result;
+            }
+            for (; first1 != last1; ++first1, ++result)
+            {
+                *result = mystl::move(*first1);
+            }
+            for (; first2 != last2; ++first2, ++result)
+            {
+                *result = mystl::move(*first2);
+            }
+            return result;
+        }
+
+        // sort 的缓冲区，析构时销毁其中的元素（constructed 为真时）并释放
+        template <class T>
+        struct sort_buffer
+        {
+            T*     ptr;
+            size_t n;
+            bool   constructed;
+
+            sort_buffer(T* p, size_t count) noexcept : ptr(p), n(count), constructed(false) {}
+
+            sort_buffer(const sort_buffer&) = delete;
+            sort_buffer& operator=(const sort_buffer&) = delete;
+
+            ~sort_buffer()
+            {
+                if (constructed)
+                {
+                    mystl::destroy(ptr, ptr + n);
+                }
+                mystl::allocator<T>::deallocate(ptr, n);
+            }
+        };
+
+        // merge_round 的切分点表需要的大小：pairs * (parts + 1) 不超过 2 * threads + runs
+        inline size_t split_table_size(size_t leaves, size_t threads) noexcept
+        {
+            return 2 * threads + leaves;
+        }
+
+        // 一轮归并：src 中每相邻的两段 [lo, mid)、[mid, hi) 归并到 dst 的 [lo, hi)，每次归并切成 parts 份
+        // 移动会修改源元素（比如 string 被移走之后为空），所以先在调用线程中算出所有的切分点，再开始归并，
+        // 计算切分点时比较函数抛出异常，这一轮的元素都还没有移动
+        // split 至少有 split_table_size(runs, threads) 个位置
+        template <class Src, class Dst, class Compared>
+        void merge_round(Src src, Dst dst, size_t n, size_t runs, size_t threads, size_t* split, Compared& comp)
+        {
+            const size_t pairs = runs / 2;
+            const size_t parts = (2 * threads + pairs - 1) / pairs;
+            // split[pair * (parts + 1) + part]：这次归并的第 part 份从第一段的哪个位置开始
+            for (size_t pair = 0; pair < pairs; ++pair)
+            {
+                const size_t lo = n * (2 * pair) / runs;
+                const size_t mid = n * (2 * pair + 1) / runs;
+                const size_t hi = n * (2 * pair + 2) / runs;
+                for (size_t part = 0; part <= parts; ++part)
+                {
+                    split[pair * (parts + 1) + part] =
+                            co_rank((hi - lo) * part / parts, src + lo, mid - lo, src + mid, hi - mid, comp);
+                }
+            }
+            auto task = [&](size_t t)
+            {
+                const size_t pair = t / parts;
+                const size_t part = t % parts;
+                const size_t lo = n * (2 * pair) / runs;
+                const size_t mid = n * (2 * pair + 1) / runs;
+                const size_t hi = n * (2 * pair + 2) / runs;
+                const size_t k0 = (hi - lo) * part / parts;
+                const size_t k1 = (hi - lo) * (part + 1) / parts;
+                const size_t i0 = split[pair * (parts + 1) + part];
+                const size_t i1 = split[pair * (parts + 1) + part + 1];
+                move_merge(src + (lo + i0), src + (lo + i1), src + (mid + (k0 - i0)), src + (mid + (k1 - i1)),
+                           dst + (lo + k0), comp);
+            };
+            run_tasks(pairs * parts, threads, task);
+        }
+
+        template <class RandomIter, class Compared>
+        void parallel_sort(RandomIter first, RandomIter last, Compared comp, size_t threads)
+        {
+            typedef typename iterator_traits<RandomIter>::value_type value_type;
+            const size_t n = static_cast<size_t>(last - first);
+            if (n < static_cast<size_t>(MYSTL_PARALLEL_SORT_THRESHOLD) || threads <= 1)
+            {
+                mystl::sort(first, last, comp);
+                return;
+            }
+            // 段数为 2 的奇数次幂，归并的轮数为奇数，排好的结果最后在原区间中
+            size_t leaves = 2;
+            while (leaves * 4 <= kMaxLeaves && n / (leaves * 4) >= kMinLeaf)
+            {
+                leaves *= 4;
+            }
+
+            // 切分点表和缓冲区都在移动任何元素之前分配，之后调用线程中不再有分配
+            mystl::vector<size_t> split;
+            value_type* raw;
+            try
+            {
+                split.resize(split_table_size(leaves, threads));
+                raw = mystl::allocator<value_type>::allocate(n);
+            }
+            catch (...)
+            {
+                mystl::sort(first, last, comp);
+                return;
+            }
+            sort_buffer<value_type> buf(raw, n);
+
+            // 各段排序之后搬到缓冲区中，缓冲区中的元素由此构造
+            auto leaf = [&](size_t i)
+            {
+                const size_t lo = n * i / leaves;
+                const size_t hi = n * (i + 1) / leaves;
+                mystl::sort(first + lo, first + hi, comp);
+                mystl::uninitialized_move(first + lo, first + hi, raw + lo);
+            };
+            run_tasks(leaves, threads, leaf);
+            buf.constructed = true;
+
+            bool in_buf = true;
+            try
+            {
+                for (size_t runs = leaves; runs > 1; runs /= 2)
+                {
+                    if (in_buf)
+                    {
+                        merge_round(raw, first, n, runs, threads, split.data(), comp);
+                    }
+                    else
+                    {
+                        merge_round(first, raw, n, runs, threads, split.data(), comp);
+                    }
+                    in_buf = !in_buf;
+                }
+            }
+            catch (...)
+            {
+                // 只有计算切分点时会抛出到这里，这一轮还没有移动元素，所有元素完整地在 in_buf 指示的一侧
+                if (in_buf)
+                {
+                    mystl::move(raw, raw + n, first);
+                }
+                throw;
+            }
+        }
+
+        template <class RandomIter1, class RandomIter2, class RandomIter3, class Compared>
+        RandomIter3 parallel_merge(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                                   RandomIter3 result, Compared comp, size_t threads)
+        {
+            const size_t n1 = static_cast<size_t>(last1 - first1);
+            const size_t n2 = static_cast<size_t>(last2 - first2);
+            const size_t n = n1 + n2;
+            if (n < static_cast<size_t>(MYSTL_PARALLEL_SORT_THRESHOLD) || threads <= 1)
+            {
+                return mystl::merge(first1, last1, first2, last2, result, comp);
+            }
+            auto task = [&](size_t p)
+            {
+                const size_t k0 = n * p / threads;
+                const size_t k1 = n * (p + 1) / threads;
+                const size_t i0 = co_rank(k0, first1, n1, first2, n2, comp);
+                const size_t i1 = co_rank(k1, first1, n1, first2, n2, comp);
+                mystl::merge(first1 + i0, first1 + i1, first2 + (k0 - i0), first2 + (k1 - i1), result + k0, comp);
+            };
+            run_tasks(threads, threads, task);
+            return result + n;
+        }
+    }
+
+    /*****************************************************************************************/
+    // sort(policy, first, last[, comp])
+    /*****************************************************************************************/
+    template <class RandomIter, class Compared>
+    void sort(const execution::sequenced_policy&, RandomIter first, RandomIter last, Compared comp)
+    {
+        mystl::sort(first, last, comp);
+    }
+
+    template <class RandomIter, class Compared>
+    void sort(const execution::parallel_policy& policy, RandomIter first, RandomIter last, Compared comp)
+    {
+        parallel_detail::parallel_sort(first, last, comp, parallel_detail::thread_count(policy));
+    }
+
+    template <class Policy, class RandomIter, typename std::enable_if<
+            is_execution_policy<typename std::decay<Policy>::type>::value, int>::type = 0>
+    void sort(Policy&& policy, RandomIter first, RandomIter last)
+    {
+        mystl::sort(policy, first, last, mystl::less_than());
+    }
+
+    /*****************************************************************************************/
+    // merge(policy, first1, last1, first2, last2, result[, comp])
+    /*****************************************************************************************/
+    template <class RandomIter1, class RandomIter2, class RandomIter3, class Compared>
+    RandomIter3 merge(const execution::sequenced_policy&, RandomIter1 first1, RandomIter1 last1,
+                      RandomIter2 first2, RandomIter2 last2, RandomIter3 result, Compared comp)
+    {
+        return mystl::merge(first1, last1, first2, last2, result, comp);
+    }
+
+    template <class RandomIter1, class RandomIter2, class RandomIter3, class Compared>
+    RandomIter3 merge(const execution::parallel_policy& policy, RandomIter1 first1, RandomIter1 last1,
+                      RandomIter2 first2, RandomIter2 last2, RandomIter3 result, Compared comp)
+    {
+        return parallel_detail::parallel_merge(first1, last1, first2, last2, result, comp,
+                                               parallel_detail::thread_count(policy));
+    }
+
+    template <class Policy, class RandomIter1, class RandomIter2, class RandomIter3, typename std::enable_if<
+            is_execution_policy<typename std::decay<Policy>::type>::value, int>::type = 0>
+    RandomIter3 merge(Policy&& policy, RandomIter1 first1, RandomIter1 last1,
+                      RandomIter2 first2, RandomIter2 last2, RandomIter3 result)
+    {
+        return mystl::merge(policy, first1, last1, first2, last2, result, mystl::less_than());
+    }
+}
+
+#endif //STL_PARALLEL_ALGO_H
@@ -0,0 +1,390 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_POOL_ALLOCATOR_H
+#define STL_POOL_ALLOCATOR_H
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+#include "allocator.h"
+#include "construct.h"
+#include "utils.h"
+
+// 这个头文件包含一个模板类 pool_allocator，接口和 allocator 一样，可以直接替换
+// 小于等于 512 字节的请求按 8 字节对齐划分为 64 个大小类，每个大小类维护一条自由链表，
+// 链表为空时从内存池（一大块连续的 chunk）中一次切出多个节点补充，allocate/deallocate 都是 O(1)
+// 大于 512 字节的请求直接交给 ::operator new / ::operator delete，对齐要求超过 8 字节的请求交给 aligned_allocate
+//
+// 线程安全：allocate/deallocate 可以在任意线程中并发调用，一个线程分配的节点可以由另一个线程释放
+// 每个大小类有自己的锁（各占一个 cache line），不同大小类的请求互不阻塞；内存池另有一把锁，只在补充自由链表时使用
+// 同一个大小类的请求仍然要排队，许多线程频繁分配同样大小的节点时（比如每个线程一个 list）应使用 node_cache.h 中
+// 带线程本地缓存的 magazine_allocator
+
+
+namespace mystl
+{
+    /*****************************************************************************************/
+    // pool_alloc_impl
+    // 和类型无关的内存池，所有的 pool_allocator<T> 共享同一个
+    /*****************************************************************************************/
+    class pool_alloc_impl
+    {
+    public:
+        enum { POOL_ALIGN = 8 };                               // 大小类的间隔
+        enum { POOL_MAX_BYTES = 512 };                         // 内存池负责的最大字节数
+        enum { POOL_NFREELISTS = POOL_MAX_BYTES / POOL_ALIGN }; // 自由链表的个数
+        enum { POOL_NOBJS = 20 };                              // 每次补充自由链表时切出的节点数
+
+    private:
+        // 自由链表的节点，空闲时存放下一个节点的指针，分配出去后整块都是用户数据
+        union obj
+        {
+            union obj* next;
+            char data[1];
+        };
+
+        // 一个大小类的自由链表和保护它的锁，对齐到 cache line，相邻的大小类不会伪共享
+        struct alignas(64) free_list_slot
+        {
+            obj*       head = nullptr;
+            std::mutex lock;
+        };
+
+        // 加锁的顺序：持有 pool_lock 时可以再锁某个大小类，持有大小类的锁时不能再锁 pool_lock
+        struct pool_state
+        {
+            free_list_slot free_list[POOL_NFREELISTS];
+            char*          start_free = nullptr;  // 内存池中剩余空间的起点
+            char*          end_free = nullptr;    // 内存池中剩余空间的终点
+            size_t         heap_size = 0;         // 一共向系统申请了多少字节，用来决定下一次 chunk 的大小
+            std::mutex     pool_lock;             // 保护 start_free、end_free、heap_size
+        };
+
+        static pool_state& state()
+        {
+            static pool_state s;
+            return s;
+        }
+
+    public:
+        // 将 bytes 上调到 8 的倍数
+        static size_t round_up(size_t bytes) noexcept
+        {
+            return (bytes + POOL_ALIGN - 1) & ~(static_cast<size_t>(POOL_ALIGN) - 1);
+        }
+
+        // bytes 所属的自由链表下标
+        static size_t freelist_index(size_t bytes) noexcept
+        {
+            return (bytes + POOL_ALIGN - 1) / POOL_ALIGN - 1;
+        }
+
+        static void* allocate(size_t bytes);
+
+        static void deallocate(void* ptr, size_t bytes) noexcept;
+
+    private:
+        static void* refill(pool_state& s, size_t n);
+
+        // 调用时持有 pool_lock
+        static char* chunk_alloc(pool_state& s, size_t size, size_t& nobjs);
+    };
+
+    // ***************
+    // allocate 从对应的自由链表中取出一个节点，链表为空时补充
+    // ***************
+    inline void* pool_alloc_impl::allocate(size_t bytes)
+    {
+        if (bytes > static_cast<size_t>(POOL_MAX_BYTES))
+        {
+            return ::operator new(bytes);
+        }
+        auto& s = state();
+        {
+            free_list_slot& slot = s.free_list[freelist_index(bytes)];
+            std::lock_guard<std::mutex> guard(slot.lock);
+            obj* result = slot.head;
+            if (result != nullptr)
+            {
+                slot.head = result->next;
+                return result;
+            }
+        }
+        // 释放大小类的锁之后再补充，补充时要锁内存池
+        return refill(s, round_up(bytes));
+    }
+
+    // ***************
+    // deallocate 把节点放回对应的自由链表，内存不会还给系统
+    // ***************
+    inline void pool_alloc_impl::deallocate(void* ptr, size_t bytes) noexcept
+    {
+        if (bytes > static_cast<size_t>(POOL_MAX_BYTES))
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        free_list_slot& slot = state().free_list[freelist_index(bytes)];
+        obj* q = static_cast<obj*>(ptr);
+        std::lock_guard<std::mutex> guard(slot.lock);
+        q->next = slot.head;
+        slot.head = q;
+    }
+
+    // ***************
+    // refill 从内存池中切出 POOL_NOBJS 个大小为 n 的节点，第一个返回给调用者，其余挂到自由链表上
+    // 新切出的节点先在锁外串好，再一次性接到自由链表的前面（其他线程可能在此期间放回了节点）
+    // ***************
+    inline void* pool_alloc_impl::refill(pool_state& s, size_t n)
+    {
+        size_t nobjs = POOL_NOBJS;
+        char* chunk;
+        {
+            std::lock_guard<std::mutex> guard(s.pool_lock);
+            chunk = chunk_alloc(s, n, nobjs);
+        }
+        if (nobjs == 1)
+        {
+            return chunk;
+        }
+        obj* result = reinterpret_cast<obj*>(chunk);
+        obj* first = reinterpret_cast<obj*>(chunk + n);
+        obj* cur = first;
+        for (size_t i = 2; i < nobjs; ++i)
+        {
+            obj* next = reinterpret_cast<obj*>(reinterpret_cast<char*>(cur) + n);
+            cur->next = next;
+            cur = next;
+        }
+        free_list_slot& slot = s.free_list[freelist_index(n)];
+        std::lock_guard<std::mutex> guard(slot.lock);
+        cur->next = slot.head;
+        slot.head = first;
+        return result;
+    }
+
+    // ***************
+    // chunk_alloc 从内存池中取出 size * nobjs 字节，不够时取尽可能多的节点，并修改 nobjs
+    // 内存池完全不够一个节点时，先把剩余的零头挂到对应的自由链表上，再向系统申请新的 chunk
+    // ***************
+    inline char* pool_alloc_impl::chunk_alloc(pool_state& s, size_t size, size_t& nobjs)
+    {
+        const size_t need_bytes = size * nobjs;
+        const size_t pool_bytes = static_cast<size_t>(s.end_free - s.start_free);
+        char* result = nullptr;
+        if (pool_bytes >= need_bytes)
+        {
+            result = s.start_free;
+            s.start_free += need_bytes;
+            return result;
+        }
+        if (pool_bytes >= size)
+        {
+            nobjs = pool_bytes / size;
+            result = s.start_free;
+            s.start_free += size * nobjs;
+            return result;
+        }
+
+        // 剩余的零头一定是 8 的倍数，放入对应的自由链表
+        if (pool_bytes > 0)
+        {
+            free_list_slot& slot = s.free_list[freelist_index(pool_bytes)];
+            std::lock_guard<std::mutex> guard(slot.lock);
+            reinterpret_cast<obj*>(s.start_free)->next = slot.head;
+            slot.head = reinterpret_cast<obj*>(s.start_free);
+        }
+
+        // 每次申请需求量的两倍，再加上一个随已申请总量增长的附加量
+        const size_t get_bytes = 2 * need_bytes + round_up(s.heap_size >> 4);
+        try
+        {
+            s.start_free = static_cast<char*>(::operator new(get_bytes));
+        }
+        catch (...)
+        {
+            // 系统内存不足，尝试从更大的大小类中借一个节点来充当内存池
+            s.start_free = s.end_free = nullptr;
+            for (size_t i = size; i <= static_cast<size_t>(POOL_MAX_BYTES); i += POOL_ALIGN)
+            {
+                free_list_slot& slot = s.free_list[freelist_index(i)];
+                std::unique_lock<std::mutex> guard(slot.lock);
+                if (slot.head != nullptr)
+                {
+                    s.start_free = reinterpret_cast<char*>(slot.head);
+                    slot.head = slot.head->next;
+                    guard.unlock();
+                    s.end_free = s.start_free + i;
+                    return chunk_alloc(s, size, nobjs);
+                }
+            }
+            throw;
+        }
+        s.end_free = s.start_free + get_bytes;
+        s.heap_size += get_bytes;
+        return chunk_alloc(s, size, nobjs);
+    }
+
+    /*****************************************************************************************/
+    // pool_allocator
+    // 和 allocator 的静态接口完全一致，只是内存来自 pool_alloc_impl
+    /*****************************************************************************************/
+    template <class T>
+    class pool_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef pool_allocator<U> other;
+        };
+
+    public:
+        pool_allocator() noexcept = default;
+
+        template <class U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        static T* allocate();
+        static T* allocate(size_type n);
+
+        // 内存池中的请求上调到所属大小类的字节数，节点剩余的空间也能放元素
+        static allocation_result<T*> allocate_at_least(size_type n);
+
+        static void deallocate(T* ptr);
+        static void deallocate(T* ptr, size_type n);
+
+        static void construct(T* ptr);
+        static void construct(T* ptr, const T& value);
+        static void construct(T* ptr, T&& value);
+
+        template <class... Args>
+        static void construct(T* ptr, Args&&... args);
+
+        static void destroy(T* ptr);
+        static void destroy(T* first, T* last);
+
+    private:
+        // 对齐要求超过内存池能保证的 8 字节时，不能放进内存池
+        static constexpr bool use_pool = alignof(T) <= static_cast<size_t>(pool_alloc_impl::POOL_ALIGN);
+    };
+
+    template <class T>
+    T* pool_allocator<T>::allocate()
+    {
+        return allocate(1);
+    }
+
+    template <class T>
+    T* pool_allocator<T>::allocate(size_type n)
+    {
+        if (n == 0)
+        {
+            return nullptr;
+        }
+        if (!use_pool)
+        {
+            return static_cast<T*>(mystl::aligned_allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(pool_alloc_impl::allocate(n * sizeof(T)));
+    }
+
+    // 释放时传入 [n, count] 中的任意值，字节数都落在同一个大小类中
+    template <class T>
+    allocation_result<T*> pool_allocator<T>::allocate_at_least(size_type n)
+    {
+        size_type count = n;
+        if (use_pool && n != 0 && n * sizeof(T) <= static_cast<size_t>(pool_alloc_impl::POOL_MAX_BYTES))
+        {
+            count = pool_alloc_impl::round_up(n * sizeof(T)) / sizeof(T);
+        }
+        return {allocate(count), count};
+    }
+
+    template <class T>
+    void pool_allocator<T>::deallocate(T* ptr)
+    {
+        deallocate(ptr, 1);
+    }
+
+    // 和 allocator 不同，这里的 n 必须和 allocate 时一致，否则节点会被放回错误的自由链表
+    template <class T>
+    void pool_allocator<T>::deallocate(T* ptr, size_type n)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        if (!use_pool)
+        {
+            mystl::aligned_deallocate(ptr, n * sizeof(T), alignof(T));
+            return;
+        }
+        pool_alloc_impl::deallocate(ptr, n * sizeof(T));
+    }
+
+    template <class T>
+    void pool_allocator<T>::construct(T* ptr)
+    {
+        mystl::construct(ptr);
+    }
+
+    template <class T>
+    void pool_allocator<T>::construct(T* ptr, const T& value)
+    {
+        mystl::construct(ptr, value);
+    }
+
+    template <class T>
+    void pool_allocator<T>::construct(T* ptr, T&& value)
+    {
+        mystl::construct(ptr, mystl::move(value));
+    }
+
+    template <class T>
+    template <class... Args>
+    void pool_allocator<T>::construct(T* ptr, Args&&... args)
+    {
+        mystl::construct(ptr, mystl::forward<Args>(args)...);
+    }
+
+    template <class T>
+    void pool_allocator<T>::destroy(T* ptr)
+    {
+        mystl::destroy(ptr);
+    }
+
+    template <class T>
+    void pool_allocator<T>::destroy(T* first, T* last)
+    {
+        mystl::destroy(first, last);
+    }
+
+    // 所有的 pool_allocator 共享同一个内存池，可以互相释放
+    template <class T, class U>
+    bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+    {
+        return false;
+    }
+
+}
+
+#endif //STL_POOL_ALLOCATOR_H
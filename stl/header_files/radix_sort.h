@@ -0,0 +1,479 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_RADIX_SORT_H
+#define STL_RADIX_SORT_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "parallel_algo.h"
+#include "uninitialized.h"
+#include "vector.h"
+
+// 这个头文件包含基数排序 radix_sort，按整数或浮点数键从小到大排序，是稳定的
+// radix_sort(first, last)：元素本身就是键；radix_sort(first, last, key)：key(元素) 返回键，用来按某个成员排序结构体
+// 键可以是有符号、无符号整数（不包括 bool）以及 float、double：
+// 有符号整数翻转符号位，浮点数为正时翻转符号位、为负时翻转所有位，之后都按无符号整数比较，
+// 所以 -0.0 排在 +0.0 之前，负的 NaN 排在最前，正的 NaN 排在最后
+//
+// 实现：先算出所有键中不全相同的最高位，按从这一位往下的 11 位（2048 个桶）做一轮 MSD 分配，
+// 把区间分成很多小桶，再逐桶排序剩下的低位：桶放得进 L2（kLeafBytes）时做每轮 8 位的 LSD，
+// 所有元素这几位都相同的轮次直接跳过；桶仍然太大时继续按下面的 11 位做 MSD，元素少于 kRadixThreshold 个时用插入排序
+// 对整个区间做多轮 LSD 时每轮都要把所有元素散布到 2048 个相距很远的位置，大区间时受限于内存带宽和 TLB，
+// 先做一轮 MSD 之后，只有这一轮需要访问整个区间，其余各轮都在缓存中完成
+// 元素在原区间和一块同样大小的缓冲区之间来回移动，每个桶的结果最后都在原区间中
+// 第一个参数为 mystl::execution::par 时，第一轮 MSD 的计数和分配按段交给多个线程，之后各个桶由多个线程领取，
+// 结果和单线程完全相同
+//
+// 可平凡复制的元素直接在缓冲区中构造；否则先用 uninitialized_move 把元素整体搬到缓冲区，之后只做移动赋值
+// key 会对同一个元素调用多次，必须每次返回相同的值并且不抛出异常；缓冲区分配失败时抛出 std::bad_alloc，区间不变；
+// 元素的移动赋值抛出异常时缓冲区被释放，区间中的元素处于有效但未指定的状态，和并行的 sort 一样，
+// 在工作线程中抛出异常时调用 std::terminate
+
+namespace mystl
+{
+    namespace radix_detail
+    {
+        constexpr size_t   kRadixThreshold = 64;                   // 少于这个数时使用插入排序
+        constexpr unsigned kRadixBits      = 11;                   // MSD 每轮处理的位数
+        constexpr size_t   kRadixBuckets   = 1 << kRadixBits;      // MSD 每轮的桶数
+        constexpr size_t   kRadixMask      = kRadixBuckets - 1;
+        constexpr unsigned kLeafBits       = 8;                    // 桶内 LSD 每轮处理的位数
+        constexpr size_t   kLeafBuckets    = 1 << kLeafBits;
+        constexpr size_t   kLeafMask       = kLeafBuckets - 1;
+        constexpr size_t   kLeafPasses     = 64 / kLeafBits;       // 64 位的键最多需要的 LSD 轮数
+        constexpr size_t   kLeafBytes      = 1 << 16;              // 不超过这个大小的桶做 LSD，和缓冲区一起放得进 L2
+        constexpr size_t   kMinChunk       = 65536;                // 多线程时每段至少的元素个数
+
+        // 元素本身作为键
+        struct identity_key
+        {
+            template <class T>
+            const T& operator()(const T& value) const noexcept { return value; }
+        };
+
+        // 把键映射为无符号整数，映射之后的大小关系和原来的键相同
+        template <class Key, bool = std::is_floating_point<Key>::value>
+        struct key_traits
+        {
+            static_assert(std::is_integral<Key>::value && !std::is_same<Key, bool>::value,
+                          "radix_sort key must be an integer or floating point type");
+
+            typedef typename std::make_unsigned<Key>::type type;
+
+            static type to_unsigned(Key key) noexcept
+            {
+                return std::is_signed<Key>::value
+                       ? static_cast<type>(static_cast<type>(key) ^ (static_cast<type>(1) << (sizeof(type) * 8 - 1)))
+                       : static_cast<type>(key);
+            }
+        };
+
+        template <class Key>
+        struct key_traits<Key, true>
+        {
+            static_assert(std::is_same<Key, float>::value || std::is_same<Key, double>::value,
+                          "radix_sort supports float and double keys");
+
+            typedef typename std::conditional<sizeof(Key) == 4, uint32_t, uint64_t>::type type;
+
+            static type to_unsigned(Key key) noexcept
+            {
+                type bits;
+                std::memcpy(&bits, &key, sizeof(bits));
+                const type sign = static_cast<type>(1) << (sizeof(type) * 8 - 1);
+                return (bits & sign) ? static_cast<type>(~bits) : static_cast<type>(bits | sign);
+            }
+        };
+
+        // 低 bits 位全为 1 的掩码
+        template <class U>
+        U low_mask(unsigned bits) noexcept
+        {
+            return bits >= sizeof(U) * 8 ? static_cast<U>(~static_cast<U>(0))
+                                         : static_cast<U>((static_cast<U>(1) << bits) - 1);
+        }
+
+        // x 的有效位数，x 为 0 时返回 0
+        template <class U>
+        unsigned bit_width(U x) noexcept
+        {
+            unsigned n = 0;
+            for (; x != 0; x = static_cast<U>(x >> 1))
+            {
+                ++n;
+            }
+            return n;
+        }
+
+        // 一轮 MSD 从 bits 位中的最高有效位往下取 kRadixBits 位，返回这一轮的移位数
+        inline unsigned msd_shift(unsigned bits) noexcept
+        {
+            return bits > kRadixBits ? bits - kRadixBits : 0;
+        }
+
+        // 移动到目标位置：可平凡复制的元素直接构造（目标是否已有元素都可以），否则目标已经构造，移动赋值
+        template <class Ptr, class T>
+        void put(Ptr dst, T& value, m_false_type)
+        {
+            *dst = mystl::move(value);
+        }
+
+        template <class Ptr, class T>
+        void put(Ptr dst, T& value, m_true_type)
+        {
+            mystl::construct(&*dst, mystl::move(value));
+        }
+
+        template <class Src, class Dst, class Construct>
+        void move_all(Src src, Dst dst, size_t n, Construct construct)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                put(dst + i, src[i], construct);
+            }
+        }
+
+        // 把 src 的 [lo, hi) 按 (键 >> shift) & mask 分配到 dst，next 为每个桶的下一个位置
+        // next 应当是调用者的局部数组：元素是 size_t 时，写 dst 会让编译器认为堆上的 next 可能被改写，每次都要重新读取
+        template <class Traits, class Src, class Dst, class KeyFn, class Construct>
+        void scatter(Src src, Dst dst, size_t lo, size_t hi, size_t* next, unsigned shift, size_t mask,
+                     KeyFn& key, Construct construct)
+        {
+            for (size_t i = lo; i < hi; ++i)
+            {
+                const size_t digit = static_cast<size_t>((Traits::to_unsigned(key(src[i])) >> shift) & mask);
+                put(dst + next[digit]++, src[i], construct);
+            }
+        }
+
+        // 按映射之后的键做稳定的插入排序
+        template <class RandomIter, class KeyFn>
+        void insertion_sort_by_key(RandomIter first, RandomIter last, KeyFn& key)
+        {
+            typedef typename iterator_traits<RandomIter>::value_type value_type;
+            typedef key_traits<typename std::decay<decltype(key(*first))>::type> traits;
+            const size_t n = static_cast<size_t>(last - first);
+            for (size_t i = 1; i < n; ++i)
+            {
+                value_type value = mystl::move(first[i]);
+                const typename traits::type k = traits::to_unsigned(key(value));
+                size_t j = i;
+                for (; j > 0 && k < traits::to_unsigned(key(first[j - 1])); --j)
+                {
+                    first[j] = mystl::move(first[j - 1]);
+                }
+                first[j] = mystl::move(value);
+            }
+        }
+
+        // 桶内的 LSD：按低 bits 位排序 src 的 n 个元素，每轮 kLeafBits 位，to_dst 为真时结果放到 dst，否则放回 src
+        template <class Traits, class Src, class Dst, class KeyFn, class Construct>
+        void lsd_sort(Src src, Dst dst, size_t n, unsigned bits, bool to_dst, KeyFn& key, Construct construct)
+        {
+            typedef typename Traits::type ukey;
+            const size_t passes = (bits + kLeafBits - 1) / kLeafBits;
+            size_t hist[kLeafPasses][kLeafBuckets];
+            for (size_t p = 0; p < passes; ++p)
+            {
+                mystl::fill_n(hist[p], kLeafBuckets, static_cast<size_t>(0));
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                const ukey k = Traits::to_unsigned(key(src[i]));
+                for (size_t p = 0; p < passes; ++p)
+                {
+                    ++hist[p][static_cast<size_t>((k >> (p * kLeafBits)) & kLeafMask)];
+                }
+            }
+
+            bool in_src = true;
+            for (size_t p = 0; p < passes; ++p)
+            {
+                // 所有元素在这一轮的数字都相同时，这一轮不改变顺序
+                size_t sum = 0;
+                bool need = true;
+                for (size_t d = 0; d < kLeafBuckets && need; ++d)
+                {
+                    const size_t count = hist[p][d];
+                    need = count != n;
+                    hist[p][d] = sum;
+                    sum += count;
+                }
+                if (!need)
+                {
+                    continue;
+                }
+                const unsigned shift = static_cast<unsigned>(p * kLeafBits);
+                if (in_src)
+                {
+                    scatter<Traits>(src, dst, 0, n, hist[p], shift, kLeafMask, key, construct);
+                }
+                else
+                {
+                    scatter<Traits>(dst, src, 0, n, hist[p], shift, kLeafMask, key, construct);
+                }
+                in_src = !in_src;
+            }
+            if (in_src && to_dst)
+            {
+                move_all(src, dst, n, construct);
+            }
+            else if (!in_src && !to_dst)
+            {
+                move_all(dst, src, n, construct);
+            }
+        }
+
+        // 排序 src 的 n 个元素，它们的键除了低 bits 位以外都相同，to_dst 为真时结果放到 dst，否则放回 src
+        template <class Traits, class Src, class Dst, class KeyFn, class Construct>
+        void sort_bucket(Src src, Dst dst, size_t n, unsigned bits, bool to_dst, KeyFn& key, Construct construct)
+        {
+            typedef typename iterator_traits<Src>::value_type value_type;
+            typedef typename Traits::type ukey;
+            if (bits == 0 || n < kRadixThreshold)
+            {
+                if (to_dst)
+                {
+                    move_all(src, dst, n, construct);
+                    if (bits != 0)
+                    {
+                        insertion_sort_by_key(dst, dst + n, key);
+                    }
+                }
+                else if (bits != 0)
+                {
+                    insertion_sort_by_key(src, src + n, key);
+                }
+                return;
+            }
+            if (n * sizeof(value_type) <= kLeafBytes || bits <= kLeafBits)
+            {
+                lsd_sort<Traits>(src, dst, n, bits, to_dst, key, construct);
+                return;
+            }
+
+            // 桶仍然太大：只有不全相同的位需要排序，从其中的最高位开始再做一轮 MSD
+            const ukey mask = low_mask<ukey>(bits);
+            const ukey k0 = Traits::to_unsigned(key(src[0]));
+            ukey diff = 0;
+            for (size_t i = 1; i < n; ++i)
+            {
+                diff = static_cast<ukey>(diff | (Traits::to_unsigned(key(src[i])) ^ k0));
+            }
+            bits = bit_width(static_cast<ukey>(diff & mask));
+            if (bits == 0 || bits <= kLeafBits)
+            {
+                lsd_sort<Traits>(src, dst, n, bits, to_dst, key, construct);
+                return;
+            }
+            const unsigned shift = msd_shift(bits);
+            size_t next[kRadixBuckets];
+            size_t bound[kRadixBuckets + 1];
+            mystl::fill_n(bound, kRadixBuckets + 1, static_cast<size_t>(0));
+            for (size_t i = 0; i < n; ++i)
+            {
+                ++bound[static_cast<size_t>((Traits::to_unsigned(key(src[i])) >> shift) & kRadixMask) + 1];
+            }
+            for (size_t d = 0; d < kRadixBuckets; ++d)
+            {
+                next[d] = bound[d];
+                bound[d + 1] += bound[d];
+            }
+            scatter<Traits>(src, dst, 0, n, next, shift, kRadixMask, key, construct);
+            // 现在元素在 dst 中，要放到 dst 时子桶的结果应当留在原处
+            for (size_t d = 0; d < kRadixBuckets; ++d)
+            {
+                sort_bucket<Traits>(dst + bound[d], src + bound[d], bound[d + 1] - bound[d], shift, !to_dst,
+                                    key, construct);
+            }
+        }
+
+        // 多线程的第一轮 MSD：按段计数、按段分配到 dst，再由多个线程逐桶排序
+        // table 至少有 (chunks + 1) * kRadixBuckets + 1 个位置
+        template <class Traits, class Src, class Dst, class KeyFn, class Construct>
+        void parallel_msd(Src src, Dst dst, size_t n, size_t chunks, size_t threads, unsigned bits, bool to_dst,
+                          size_t* table, KeyFn& key, Construct construct)
+        {
+            const unsigned shift = msd_shift(bits);
+            // table[c * kRadixBuckets + d]：第 c 段中数字为 d 的元素个数，之后改为下一个元素的位置，
+            // 桶内按段的顺序排列，保证稳定；bound 为每个桶的起点
+            size_t* bound = table + chunks * kRadixBuckets;
+            auto count = [&](size_t c)
+            {
+                size_t* h = table + c * kRadixBuckets;
+                mystl::fill_n(h, kRadixBuckets, static_cast<size_t>(0));
+                const size_t hi = n * (c + 1) / chunks;
+                for (size_t i = n * c / chunks; i < hi; ++i)
+                {
+                    ++h[static_cast<size_t>((Traits::to_unsigned(key(src[i])) >> shift) & kRadixMask)];
+                }
+            };
+            parallel_detail::run_tasks(chunks, threads, count);
+
+            size_t sum = 0;
+            for (size_t d = 0; d < kRadixBuckets; ++d)
+            {
+                bound[d] = sum;
+                for (size_t c = 0; c < chunks; ++c)
+                {
+                    const size_t count_cd = table[c * kRadixBuckets + d];
+                    table[c * kRadixBuckets + d] = sum;
+                    sum += count_cd;
+                }
+            }
+            bound[kRadixBuckets] = sum;
+
+            auto pass = [&](size_t c)
+            {
+                size_t next[kRadixBuckets];
+                mystl::copy(table + c * kRadixBuckets, table + (c + 1) * kRadixBuckets, next);
+                scatter<Traits>(src, dst, n * c / chunks, n * (c + 1) / chunks, next, shift, kRadixMask,
+                                key, construct);
+            };
+            parallel_detail::run_tasks(chunks, threads, pass);
+
+            auto bucket = [&](size_t d)
+            {
+                sort_bucket<Traits>(dst + bound[d], src + bound[d], bound[d + 1] - bound[d], shift, !to_dst,
+                                    key, construct);
+            };
+            parallel_detail::run_tasks(kRadixBuckets, threads, bucket);
+        }
+
+        // 从 src 排序到 dst（to_dst 为真）或放回 src；chunks 大于 1 时第一轮 MSD 使用多个线程
+        template <class Traits, class Src, class Dst, class KeyFn, class Construct>
+        void sort_range(Src src, Dst dst, size_t n, size_t chunks, size_t threads, unsigned bits, bool to_dst,
+                        size_t* table, KeyFn& key, Construct construct)
+        {
+            if (chunks > 1)
+            {
+                parallel_msd<Traits>(src, dst, n, chunks, threads, bits, to_dst, table, key, construct);
+            }
+            else
+            {
+                sort_bucket<Traits>(src, dst, n, bits, to_dst, key, construct);
+            }
+        }
+
+        template <class RandomIter, class KeyFn>
+        void radix_sort(RandomIter first, RandomIter last, KeyFn& key, size_t threads)
+        {
+            typedef typename iterator_traits<RandomIter>::value_type value_type;
+            typedef key_traits<typename std::decay<decltype(key(*first))>::type> traits;
+            typedef typename traits::type ukey;
+
+            const size_t n = static_cast<size_t>(last - first);
+            if (n < kRadixThreshold)
+            {
+                insertion_sort_by_key(first, last, key);
+                return;
+            }
+            size_t chunks = n / kMinChunk;
+            chunks = chunks < threads ? chunks : threads;
+            chunks = chunks != 0 ? chunks : 1;
+            unsigned bits = static_cast<unsigned>(sizeof(ukey) * 8);
+
+            // 多线程时先并行地找出不全相同的最高位，第一轮 MSD 从这一位开始；单线程时由 sort_bucket 在需要时计算
+            // 计数表在缓冲区之前分配：缓冲区分配之后（元素可能已经搬进去）不再有会失败的分配
+            mystl::vector<size_t> table;
+            if (chunks > 1)
+            {
+                table.resize((chunks + 1) * kRadixBuckets + 1);
+                mystl::vector<ukey> diff(chunks);
+                const ukey k0 = traits::to_unsigned(key(first[0]));
+                auto scan = [&](size_t c)
+                {
+                    ukey d = 0;
+                    const size_t hi = n * (c + 1) / chunks;
+                    for (size_t i = n * c / chunks; i < hi; ++i)
+                    {
+                        d = static_cast<ukey>(d | (traits::to_unsigned(key(first[i])) ^ k0));
+                    }
+                    diff[c] = d;
+                };
+                parallel_detail::run_tasks(chunks, threads, scan);
+                ukey all = 0;
+                for (size_t c = 0; c < chunks; ++c)
+                {
+                    all = static_cast<ukey>(all | diff[c]);
+                }
+                bits = bit_width(all);
+                if (bits == 0)
+                {
+                    return;
+                }
+            }
+
+            parallel_detail::sort_buffer<value_type> buf(mystl::allocator<value_type>::allocate(n), n);
+            if (std::is_trivially_copyable<value_type>::value)
+            {
+                // 析构是平凡的，缓冲区不需要销毁
+                sort_range<traits>(first, buf.ptr, n, chunks, threads, bits, false, table.data(), key,
+                                   m_true_type());
+            }
+            else
+            {
+                // 先整体搬到缓冲区，由 uninitialized_move 负责失败时的清理，之后两边都已经构造，只做移动赋值
+                mystl::uninitialized_move(first, last, buf.ptr);
+                buf.constructed = true;
+                sort_range<traits>(buf.ptr, first, n, chunks, threads, bits, true, table.data(), key,
+                                   m_false_type());
+            }
+        }
+    }
+
+    /*****************************************************************************************/
+    // radix_sort
+    // 按整数或浮点数键稳定排序，只接受随机访问迭代器
+    /*****************************************************************************************/
+    template <class RandomIter, class KeyFn>
+    void radix_sort(RandomIter first, RandomIter last, KeyFn key)
+    {
+        radix_detail::radix_sort(first, last, key, 1);
+    }
+
+    template <class RandomIter>
+    void radix_sort(RandomIter first, RandomIter last)
+    {
+        radix_detail::identity_key key;
+        radix_detail::radix_sort(first, last, key, 1);
+    }
+
+    template <class RandomIter, class KeyFn>
+    void radix_sort(const execution::sequenced_policy&, RandomIter first, RandomIter last, KeyFn key)
+    {
+        radix_detail::radix_sort(first, last, key, 1);
+    }
+
+    template <class RandomIter>
+    void radix_sort(const execution::sequenced_policy&, RandomIter first, RandomIter last)
+    {
+        radix_detail::identity_key key;
+        radix_detail::radix_sort(first, last, key, 1);
+    }
+
+    template <class RandomIter, class KeyFn>
+    void radix_sort(const execution::parallel_policy& policy, RandomIter first, RandomIter last, KeyFn key)
+    {
+        radix_detail::radix_sort(first, last, key, parallel_detail::thread_count(policy));
+    }
+
+    template <class RandomIter>
+    void radix_sort(const execution::parallel_policy& policy, RandomIter first, RandomIter last)
+    {
+        radix_detail::identity_key key;
+        radix_detail::radix_sort(first, last, key, parallel_detail::thread_count(policy));
+    }
+}
+
+#endif //STL_RADIX_SORT_H
@@ -0,0 +1,262 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_SIMD_REMOVE_H
+#define STL_SIMD_REMOVE_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// 这个头文件包含连续存储的算术类型（4 字节或 8 字节）的 remove(first, last, value)，供 algorithm.h 中的 remove 使用
+// 每次比较一组元素得到要保留的位掩码，用掩码查表得到压缩（compress）用的排列，排列之后整组写出，
+// 写指针按保留的个数前进；x86 上运行时检测 CPU，AVX2 一次处理 8 个 32 位或 4 个 64 位元素，
+// 只有 SSSE3 时一次处理 4 个 32 位元素，其它情况（以及不是 GCC/Clang 的编译器）使用无分支的标量循环
+// 定义 MYSTL_NO_SIMD 可以关闭 SIMD 路径
+
+#if !defined(MYSTL_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MYSTL_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace mystl
+{
+    // 可以使用 simd_remove 的类型：4 字节或 8 字节的算术类型（bool 除外）
+    template <class T>
+    struct simd_removable : public std::integral_constant<bool,
+            std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+            (sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+    namespace simd_detail
+    {
+        // 无分支的标量压缩：每个元素都写出，写指针只在保留时前进
+        template <class T>
+        T* scalar_remove(T* first, T* last, T* out, const T value) noexcept
+        {
+            for (; first != last; ++first)
+            {
+                const T x = *first;
+                *out = x;
+                out += !(x == value);
+            }
+            return out;
+        }
+
+#ifdef MYSTL_X86_SIMD
+        // 压缩用的查找表，下标是要保留的元素的位掩码
+        struct compress_tables
+        {
+            alignas(32) uint32_t lane32x8[256][8];   // AVX2，8 个 32 位元素，_mm256_permutevar8x32_epi32 的下标
+            alignas(32) uint32_t lane64x4[16][8];    // AVX2，4 个 64 位元素，按 32 位的一对下标表示
+            alignas(16) uint8_t  lane32x4[16][16];   // SSSE3，4 个 32 位元素，_mm_shuffle_epi8 的字节下标
+
+            compress_tables() noexcept
+            {
+                std::memset(this, 0, sizeof(*this));
+                for (unsigned mask = 0; mask < 256; ++mask)
+                {
+                    unsigned k = 0;
+                    for (unsigned i = 0; i < 8; ++i)
+                    {
+                        if (mask & (1u << i))
+                        {
+                            lane32x8[mask][k++] = i;
+                        }
+                    }
+                }
+                for (unsigned mask = 0; mask < 16; ++mask)
+                {
+                    unsigned k = 0;
+                    for (unsigned i = 0; i < 4; ++i)
+                    {
+                        if (mask & (1u << i))
+                        {
+                            lane64x4[mask][2 * k] = 2 * i;
+                            lane64x4[mask][2 * k + 1] = 2 * i + 1;
+                            for (unsigned b = 0; b < 4; ++b)
+                            {
+                                lane32x4[mask][4 * k + b] = static_cast<uint8_t>(4 * i + b);
+                            }
+                            ++k;
+                        }
+                    }
+                }
+            }
+        };
+
+        inline const compress_tables& tables() noexcept
+        {
+            static const compress_tables t;
+            return t;
+        }
+
+        enum { LEVEL_SCALAR = 0, LEVEL_SSSE3 = 1, LEVEL_AVX2 = 2 };
+
+        // 运行时检测一次，之后直接使用结果
+        inline int cpu_level() noexcept
+        {
+            static const int level = []() {
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx2"))
+                {
+                    return static_cast<int>(LEVEL_AVX2);
+                }
+                if (__builtin_cpu_supports("ssse3"))
+                {
+                    return static_cast<int>(LEVEL_SSSE3);
+                }
+                return static_cast<int>(LEVEL_SCALAR);
+            }();
+            return level;
+        }
+
+        template <class T>
+        inline uint32_t bits32(const T& value) noexcept
+        {
+            uint32_t b;
+            std::memcpy(&b, &value, sizeof(b));
+            return b;
+        }
+
+        template <class T>
+        inline uint64_t bits64(const T& value) noexcept
+        {
+            uint64_t b;
+            std::memcpy(&b, &value, sizeof(b));
+            return b;
+        }
+
+        // 每组都整组写出，超出保留个数的部分落在已经读过的位置上，之后会被覆盖或者位于返回值之后
+        template <class T>
+        __attribute__((target("avx2")))
+        T* avx2_remove32(T* first, T* last, const T value) noexcept
+        {
+            const compress_tables& t = tables();
+            const __m256i v = _mm256_set1_epi32(static_cast<int>(bits32(value)));
+            T* out = first;
+            for (; last - first >= 8; first += 8)
+            {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+                int eq;
+                if (std::is_floating_point<T>::value)
+                {
+                    eq = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(x), _mm256_castsi256_ps(v), _CMP_EQ_OQ));
+                }
+                else
+                {
+                    eq = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v)));
+                }
+                const unsigned keep = ~static_cast<unsigned>(eq) & 0xffu;
+                const __m256i idx = _mm256_load_si256(reinterpret_cast<const __m256i*>(t.lane32x8[keep]));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(x, idx));
+                out += __builtin_popcount(keep);
+            }
+            return scalar_remove(first, last, out, value);
+        }
+
+        template <class T>
+        __attribute__((target("avx2")))
+        T* avx2_remove64(T* first, T* last, const T value) noexcept
+        {
+            const compress_tables& t = tables();
+            const __m256i v = _mm256_set1_epi64x(static_cast<long long>(bits64(value)));
+            T* out = first;
+            for (; last - first >= 4; first += 4)
+            {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+                int eq;
+                if (std::is_floating_point<T>::value)
+                {
+                    eq = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_castsi256_pd(x), _mm256_castsi256_pd(v), _CMP_EQ_OQ));
+                }
+                else
+                {
+                    eq = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, v)));
+                }
+                const unsigned keep = ~static_cast<unsigned>(eq) & 0xfu;
+                const __m256i idx = _mm256_load_si256(reinterpret_cast<const __m256i*>(t.lane64x4[keep]));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(x, idx));
+                out += __builtin_popcount(keep);
+            }
+            return scalar_remove(first, last, out, value);
+        }
+
+        template <class T>
+        __attribute__((target("ssse3")))
+        T* ssse3_remove32(T* first, T* last, const T value) noexcept
+        {
+            const compress_tables& t = tables();
+            const __m128i v = _mm_set1_epi32(static_cast<int>(bits32(value)));
+            T* out = first;
+            for (; last - first >= 4; first += 4)
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+                int eq;
+                if (std::is_floating_point<T>::value)
+                {
+                    eq = _mm_movemask_ps(_mm_cmpeq_ps(_mm_castsi128_ps(x), _mm_castsi128_ps(v)));
+                }
+                else
+                {
+                    eq = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, v)));
+                }
+                const unsigned keep = ~static_cast<unsigned>(eq) & 0xfu;
+                const __m128i idx = _mm_load_si128(reinterpret_cast<const __m128i*>(t.lane32x4[keep]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(x, idx));
+                out += __builtin_popcount(keep);
+            }
+            return scalar_remove(first, last, out, value);
+        }
+
+        template <class T>
+        T* dispatch_remove(T* first, T* last, const T value, std::integral_constant<size_t, 4>) noexcept
+        {
+            switch (cpu_level())
+            {
+                case LEVEL_AVX2:
+                    return avx2_remove32(first, last, value);
+                case LEVEL_SSSE3:
+                    return ssse3_remove32(first, last, value);
+                default:
+                    return scalar_remove(first, last, first, value);
+            }
+        }
+
+        template <class T>
+        T* dispatch_remove(T* first, T* last, const T value, std::integral_constant<size_t, 8>) noexcept
+        {
+            if (cpu_level() == LEVEL_AVX2)
+            {
+                return avx2_remove64(first, last, value);
+            }
+            return scalar_remove(first, last, first, value);
+        }
+#endif
+    }
+
+    // 移除 [first, last) 中等于 value 的元素，保留的元素保持原来的顺序，返回新的尾部，[返回值, last) 中的值不确定
+    template <class T>
+    T* simd_remove(T* first, T* last, const T value) noexcept
+    {
+        static_assert(simd_removable<T>::value, "simd_remove needs a 4 or 8 byte arithmetic type");
+        // 跳过开头不需要移动的元素，没有要移除的元素时不写内存
+        while (first != last && !(*first == value))
+        {
+            ++first;
+        }
+        if (first == last)
+        {
+            return last;
+        }
+#ifdef MYSTL_X86_SIMD
+        return simd_detail::dispatch_remove(first, last, value, std::integral_constant<size_t, sizeof(T)>());
+#else
+        return simd_detail::scalar_remove(first, last, first, value);
+#endif
+    }
+}
+
+#endif //STL_SIMD_REMOVE_H
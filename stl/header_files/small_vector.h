@@ -0,0 +1,657 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_SMALL_VECTOR_H
+#define STL_SMALL_VECTOR_H
+#pragma once
+
+#include "allocator.h"
+#include "utils.h"
+#include "algobase.h"
+#include "algorithm.h"
+#include "uninitialized.h"
+#include "iterator.h"
+#include "memory.h"
+#include "growth_policy.h"
+#include "hardening.h"
+
+#include <cassert>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+// 这个头文件包含模板类 small_vector<T, N>，接口和 vector 一样
+// 前 N 个元素放在对象内部的缓冲区中，不分配内存；超过 N 个之后搬到堆上，之后和 vector 一样按 default_growth 增长
+// 适合大部分时候只有几个元素的小数组，省掉大量的小块分配，元素和对象本身在同一块缓存里
+// 和 vector 不同，移动一个元素在内部缓冲区中的 small_vector 需要逐个移动元素，而不只是交换指针
+
+namespace mystl {
+
+    template<class T, size_t N, class Alloc = mystl::allocator<T>>
+    class small_vector : private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>> {
+        static_assert(N > 0, "small_vector needs at least one inline element, use vector instead");
+    public:
+        typedef Alloc allocator_type;
+        typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> data_allocator;
+        typedef mystl::allocator_traits<data_allocator> alloc_traits;
+
+        typedef typename data_allocator::value_type value_type;
+        typedef typename data_allocator::pointer pointer;
+        typedef typename data_allocator::const_pointer const_pointer;
+        typedef typename data_allocator::reference reference;
+        typedef typename data_allocator::const_reference const_reference;
+        typedef typename data_allocator::size_type size_type;
+        typedef typename data_allocator::difference_type difference_type;
+
+        typedef value_type* iterator;
+        typedef const value_type* const_iterator;
+        typedef mystl::reverse_iterator<iterator> reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        // 内部缓冲区能放下的元素个数
+        static constexpr size_type inline_capacity = N;
+
+        allocator_type get_allocator() const { return allocator_type(data_alloc()); }
+
+    private:
+        typedef mystl::alloc_holder<data_allocator> alloc_base;
+
+        data_allocator &data_alloc() noexcept { return this->get_alloc(); }
+
+        const data_allocator &data_alloc() const noexcept { return this->get_alloc(); }
+
+        iterator i_begin;   //使用空间的头部
+        iterator i_end;     //使用空间的尾部
+        iterator i_cap;     //占用空间的尾部
+        typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type i_buf;   // 内部缓冲区
+
+        // 元素可以按位搬移时，搬到堆上、插入时的后移、删除时的前移都只需要一次 memcpy/memmove
+        static constexpr bool relocatable = mystl::is_trivially_relocatable<value_type>::value;
+
+        iterator inline_data() noexcept { return reinterpret_cast<iterator>(&i_buf); }
+
+        // 回到空的内部缓冲区，不析构元素也不释放空间
+        void reset_inline() noexcept {
+            i_begin = inline_data();
+            i_end = i_begin;
+            i_cap = i_begin + N;
+        }
+
+    public:
+        small_vector() noexcept {
+            reset_inline();
+        }
+
+        explicit small_vector(const allocator_type &alloc) noexcept: alloc_base(data_allocator(alloc)) {
+            reset_inline();
+        }
+
+        explicit small_vector(size_type n, const allocator_type &alloc = allocator_type())
+                : alloc_base(data_allocator(alloc)) {
+            reset_inline();
+            fill_insert(i_end, n, value_type());
+        }
+
+        small_vector(size_type n, const value_type &value, const allocator_type &alloc = allocator_type())
+                : alloc_base(data_allocator(alloc)) {
+            reset_inline();
+            fill_insert(i_end, n, value);
+        }
+
+        template<class Iter, typename std::enable_if<mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        small_vector(Iter first, Iter last, const allocator_type &alloc = allocator_type())
+                : alloc_base(data_allocator(alloc)) {
+            reset_inline();
+            range_init(first, last);
+        }
+
+        small_vector(std::initializer_list<value_type> ilist, const allocator_type &alloc = allocator_type())
+                : alloc_base(data_allocator(alloc)) {
+            reset_inline();
+            range_init(ilist.begin(), ilist.end());
+        }
+
+        // 拷贝构造，分配器由 select_on_container_copy_construction 决定
+        small_vector(const small_vector &rhs)
+                : alloc_base(alloc_traits::select_on_container_copy_construction(rhs.data_alloc())) {
+            reset_inline();
+            range_init(rhs.i_begin, rhs.i_end);
+        }
+
+        // 移动构造，rhs 在堆上时直接接管，在内部缓冲区时逐个移动元素，之后 rhs 为空
+        small_vector(small_vector &&rhs) noexcept(std::is_nothrow_move_constructible<value_type>::value)
+                : alloc_base(mystl::move(rhs.data_alloc())) {
+            reset_inline();
+            steal(rhs);
+        }
+
+        small_vector &operator=(const small_vector &rhs);
+
+        small_vector &operator=(small_vector &&rhs);
+
+        small_vector &operator=(std::initializer_list<value_type> ilist);
+
+        ~small_vector() {
+            release();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return i_begin; }
+
+        const_iterator begin() const noexcept { return i_begin; }
+
+        iterator end() noexcept { return i_end; }
+
+        const_iterator end() const noexcept { return i_end; }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return i_begin == i_end; }
+
+        size_type size() const noexcept { return static_cast<size_type>(i_end - i_begin); }
+
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(value_type); }
+
+        size_type capacity() const noexcept { return static_cast<size_type>(i_cap - i_begin); }
+
+        // 元素是否还在内部缓冲区中
+        bool is_inline() const noexcept {
+            return i_begin == reinterpret_cast<const_iterator>(&i_buf);
+        }
+
+        // reserve(n) 保证容量至少为 n，不超过 N 时什么都不做
+        void reserve(size_type n);
+
+        // shrink_to_fit 元素不超过 N 个时搬回内部缓冲区并释放堆上的空间，否则缩小到正好放下所有元素
+        void shrink_to_fit();
+
+        // 访问元素相关操作
+        reference operator[](size_type n) {
+            MYSTL_HARDENING_ASSERT(n < size(), "small_vector::operator[] index out of range");
+            return *(i_begin + n);
+        }
+
+        const_reference operator[](size_type n) const {
+            MYSTL_HARDENING_ASSERT(n < size(), "small_vector::operator[] index out of range");
+            return *(i_begin + n);
+        }
+
+        reference at(size_type n) {
+            if (n >= size()) {
+                throw std::out_of_range("small_vector<T, N>::at() subscript out of range");
+            }
+            return (*this)[n];
+        }
+
+        const_reference at(size_type n) const {
+            if (n >= size()) {
+                throw std::out_of_range("small_vector<T, N>::at() subscript out of range");
+            }
+            return (*this)[n];
+        }
+
+        reference front() {
+            MYSTL_HARDENING_ASSERT(!empty(), "small_vector::front() on empty small_vector");
+            return *i_begin;
+        }
+
+        const_reference front() const {
+            MYSTL_HARDENING_ASSERT(!empty(), "small_vector::front() on empty small_vector");
+            return *i_begin;
+        }
+
+        reference back() {
+            MYSTL_HARDENING_ASSERT(!empty(), "small_vector::back() on empty small_vector");
+            return *(i_end - 1);
+        }
+
+        const_reference back() const {
+            MYSTL_HARDENING_ASSERT(!empty(), "small_vector::back() on empty small_vector");
+            return *(i_end - 1);
+        }
+
+        pointer data() noexcept { return i_begin; }
+
+        const_pointer data() const noexcept { return i_begin; }
+
+        // 修改容器相关操作
+        void push_back(const value_type &value) {
+            emplace_back(value);
+        }
+
+        void push_back(value_type &&value) {
+            emplace_back(mystl::move(value));
+        }
+
+        template<class... Args>
+        reference emplace_back(Args &&...args);
+
+        void pop_back() {
+            MYSTL_HARDENING_ASSERT(!empty(), "small_vector::pop_back() on empty small_vector");
+            --i_end;
+            data_alloc().destroy(i_end);
+        }
+
+        iterator insert(const_iterator pos, const value_type &value) {
+            return fill_insert(const_cast<iterator>(pos), 1, value);
+        }
+
+        iterator insert(const_iterator pos, value_type &&value) {
+            return emplace(pos, mystl::move(value));
+        }
+
+        iterator insert(const_iterator pos, size_type n, const value_type &value) {
+            return fill_insert(const_cast<iterator>(pos), n, value);
+        }
+
+        template<class... Args>
+        iterator emplace(const_iterator pos, Args &&...args);
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last);
+
+        void clear() noexcept {
+            data_alloc().destroy(i_begin, i_end);
+            i_end = i_begin;
+        }
+
+        void resize(size_type new_size, const value_type &value);
+
+        void resize(size_type new_size) { resize(new_size, value_type()); }
+
+        // swap 两边都在堆上时只交换指针，否则逐个移动元素
+        void swap(small_vector &rhs);
+
+    private:
+        template<class Iter>
+        void range_init(Iter first, Iter last);
+
+        // 把元素搬到至少能放 new_cap 个元素的堆空间上
+        void grow_to(size_type new_cap);
+
+        // 再放 add_size 个元素需要的容量
+        size_type get_new_cap(size_type add_size) const;
+
+        // 把 [i_begin, i_end) 搬到 new_begin，然后释放原来的空间（内部缓冲区不用释放）
+        void relocate_to(iterator new_begin, size_type new_cap);
+
+        // 从 rhs 接管所有元素，调用前自己必须为空的内部缓冲区，之后 rhs 为空
+        void steal(small_vector &rhs);
+
+        // 在 pos 处插入 n 个 value，value 不能是容器中的元素
+        iterator fill_insert(iterator pos, size_type n, const value_type &value);
+
+        // 析构所有元素，释放堆上的空间
+        void release() noexcept;
+    };
+
+
+// ***************
+// 赋值
+// ***************
+    template<class T, size_t N, class Alloc>
+    small_vector<T, N, Alloc> &small_vector<T, N, Alloc>::operator=(const small_vector &rhs) {
+        if (this != &rhs) {
+            // propagate_on_container_copy_assignment 为真时使用rhs的分配器，原来的空间要先用自己的分配器释放
+            if (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (!alloc_traits::equal(data_alloc(), rhs.data_alloc())) {
+                    release();
+                    reset_inline();
+                }
+                data_alloc() = rhs.data_alloc();
+            }
+            clear();
+            reserve(rhs.size());
+            i_end = mystl::uninitialized_copy(rhs.i_begin, rhs.i_end, i_begin);
+        }
+        return *this;
+    }
+
+    template<class T, size_t N, class Alloc>
+    small_vector<T, N, Alloc> &small_vector<T, N, Alloc>::operator=(small_vector &&rhs) {
+        if (this != &rhs) {
+            if (alloc_traits::propagate_on_container_move_assignment::value ||
+                alloc_traits::equal(data_alloc(), rhs.data_alloc())) {
+                release();
+                reset_inline();
+                if (alloc_traits::propagate_on_container_move_assignment::value) {
+                    data_alloc() = mystl::move(rhs.data_alloc());
+                }
+                steal(rhs);
+            } else {
+                // 分配器不相等，只能用自己的分配器逐个移动元素
+                clear();
+                reserve(rhs.size());
+                i_end = mystl::uninitialized_move(rhs.i_begin, rhs.i_end, i_begin);
+                rhs.clear();
+            }
+        }
+        return *this;
+    }
+
+    template<class T, size_t N, class Alloc>
+    small_vector<T, N, Alloc> &small_vector<T, N, Alloc>::operator=(std::initializer_list<value_type> ilist) {
+        clear();
+        reserve(ilist.size());
+        i_end = mystl::uninitialized_copy(ilist.begin(), ilist.end(), i_begin);
+        return *this;
+    }
+
+// ***************
+// reserve
+// ***************
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::reserve(size_type n) {
+        if (n <= capacity()) {
+            return;
+        }
+        if (n > max_size()) {
+            throw std::length_error("n can not larger than max_size() in small_vector<T, N>::reserve(n)");
+        }
+        grow_to(n);
+    }
+
+// ***************
+// shrink_to_fit
+// ***************
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::shrink_to_fit() {
+        if (is_inline()) {
+            return;
+        }
+        if (size() <= N) {
+            relocate_to(inline_data(), N);
+            return;
+        }
+        if (size() < capacity()) {
+            // allocate_at_least 可能上调到和原来一样大，这时不搬移，直接释放新空间
+            auto result = alloc_traits::allocate_at_least(data_alloc(), size());
+            if (result.count >= capacity()) {
+                data_alloc().deallocate(result.ptr, result.count);
+                return;
+            }
+            try {
+                relocate_to(result.ptr, result.count);
+            } catch (...) {
+                data_alloc().deallocate(result.ptr, result.count);
+                throw;
+            }
+        }
+    }
+
+// ***************
+// emplace_back
+// ***************
+    template<class T, size_t N, class Alloc>
+    template<class... Args>
+    typename small_vector<T, N, Alloc>::reference small_vector<T, N, Alloc>::emplace_back(Args &&...args) {
+        if (i_end != i_cap) {
+            data_alloc().construct(mystl::address_of(*i_end), mystl::forward<Args>(args)...);
+        } else {
+            // args 可能引用容器中的元素，先构造出来再扩容
+            value_type value(mystl::forward<Args>(args)...);
+            grow_to(get_new_cap(1));
+            data_alloc().construct(mystl::address_of(*i_end), mystl::move(value));
+        }
+        ++i_end;
+        return *(i_end - 1);
+    }
+
+// ***************
+// emplace
+// ***************
+    template<class T, size_t N, class Alloc>
+    template<class... Args>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::emplace(const_iterator pos, Args &&...args) {
+        MYSTL_HARDENING_ASSERT(pos >= begin() && pos <= end(), "small_vector::emplace position out of range");
+        const size_type xpos = static_cast<size_type>(pos - i_begin);
+        if (pos == i_end) {
+            emplace_back(mystl::forward<Args>(args)...);
+            return i_begin + xpos;
+        }
+        // 先构造出新元素，args 引用容器中的元素时后移不会影响它
+        value_type value(mystl::forward<Args>(args)...);
+        if (i_end == i_cap) {
+            grow_to(get_new_cap(1));
+        }
+        iterator p = i_begin + xpos;
+        if (relocatable) {
+            mystl::uninitialized_relocate(p, i_end, p + 1);
+            data_alloc().construct(mystl::address_of(*p), mystl::move(value));
+        } else {
+            data_alloc().construct(mystl::address_of(*i_end), mystl::move(*(i_end - 1)));
+            mystl::move_backward(p, i_end - 1, i_end);
+            *p = mystl::move(value);
+        }
+        ++i_end;
+        return p;
+    }
+
+// ***************
+// fill_insert
+// ***************
+    template<class T, size_t N, class Alloc>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::fill_insert(iterator pos, size_type n, const value_type &value) {
+        MYSTL_HARDENING_ASSERT(pos >= begin() && pos <= end(), "small_vector::insert position out of range");
+        const size_type xpos = static_cast<size_type>(pos - i_begin);
+        if (n == 0) {
+            return pos;
+        }
+        // value 可能是容器中的元素，扩容或后移之后会失效，先拷贝一份
+        const value_type value_copy = value;
+        if (static_cast<size_type>(i_cap - i_end) < n) {
+            grow_to(get_new_cap(n));
+        }
+        pos = i_begin + xpos;
+        const iterator old_end = i_end;
+        const size_type after_elems = static_cast<size_type>(old_end - pos);
+        if (relocatable) {
+            // 整体后移 n 个位置，在空出来的位置上构造，构造失败时移回去
+            mystl::uninitialized_relocate(pos, old_end, pos + n);
+            try {
+                mystl::uninitialized_fill_n(pos, n, value_copy);
+            } catch (...) {
+                mystl::uninitialized_relocate(pos + n, old_end + n, pos);
+                throw;
+            }
+            i_end += n;
+        } else if (after_elems > n) {
+            i_end = mystl::uninitialized_move(old_end - n, old_end, old_end);
+            mystl::move_backward(pos, old_end - n, old_end);
+            mystl::fill_n(pos, n, value_copy);
+        } else {
+            i_end = mystl::uninitialized_fill_n(old_end, n - after_elems, value_copy);
+            i_end = mystl::uninitialized_move(pos, old_end, i_end);
+            mystl::fill(pos, old_end, value_copy);
+        }
+        return pos;
+    }
+
+// ***************
+// erase
+// ***************
+    template<class T, size_t N, class Alloc>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::erase(const_iterator first, const_iterator last) {
+        MYSTL_HARDENING_ASSERT(first >= begin() && last <= end() && !(last < first), "small_vector::erase range out of range");
+        iterator xfirst = i_begin + (first - i_begin);
+        iterator xlast = i_begin + (last - i_begin);
+        if (relocatable) {
+            data_alloc().destroy(xfirst, xlast);
+            mystl::uninitialized_relocate(xlast, i_end, xfirst);
+        } else {
+            data_alloc().destroy(mystl::move(xlast, i_end, xfirst), i_end);
+        }
+        i_end -= (xlast - xfirst);
+        return xfirst;
+    }
+
+// ***************
+// resize
+// ***************
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::resize(size_type new_size, const value_type &value) {
+        if (new_size < size()) {
+            erase(i_begin + new_size, i_end);
+        } else {
+            fill_insert(i_end, new_size - size(), value);
+        }
+    }
+
+// ***************
+// swap
+// ***************
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::swap(small_vector &rhs) {
+        if (this == &rhs) {
+            return;
+        }
+        if (!is_inline() && !rhs.is_inline()) {
+            mystl::swap(i_begin, rhs.i_begin);
+            mystl::swap(i_end, rhs.i_end);
+            mystl::swap(i_cap, rhs.i_cap);
+            if (alloc_traits::propagate_on_container_swap::value) {
+                mystl::swap(data_alloc(), rhs.data_alloc());
+            }
+            return;
+        }
+        small_vector temp(mystl::move(*this));
+        *this = mystl::move(rhs);
+        rhs = mystl::move(temp);
+    }
+
+// ***************
+// range_init
+// ***************
+    template<class T, size_t N, class Alloc>
+    template<class Iter>
+    void small_vector<T, N, Alloc>::range_init(Iter first, Iter last) {
+        reserve(static_cast<size_type>(mystl::distance(first, last)));
+        i_end = mystl::uninitialized_copy(first, last, i_begin);
+    }
+
+// ***************
+// get_new_cap 和 vector 一样由 default_growth 决定，从 N 开始增长
+// ***************
+    template<class T, size_t N, class Alloc>
+    typename small_vector<T, N, Alloc>::size_type small_vector<T, N, Alloc>::get_new_cap(size_type add_size) const {
+        const size_type old_cap = capacity();
+        if (add_size > max_size() - old_cap) {
+            throw std::length_error("small_vector<T, N> too long");
+        }
+        return mystl::default_growth::grow(old_cap, old_cap + add_size, max_size(), sizeof(value_type));
+    }
+
+// ***************
+// grow_to
+// ***************
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::grow_to(size_type new_cap) {
+        auto result = alloc_traits::allocate_at_least(data_alloc(), new_cap);
+        try {
+            relocate_to(result.ptr, result.count);
+        } catch (...) {
+            data_alloc().deallocate(result.ptr, result.count);
+            throw;
+        }
+    }
+
+// ***************
+// relocate_to
+// ***************
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::relocate_to(iterator new_begin, size_type new_cap) {
+        const size_type old_size = size();
+        const bool was_inline = is_inline();
+        const size_type old_cap = capacity();
+        // 失败时 uninitialized_relocate 已经析构了新空间中构造好的元素，原来的元素不变
+        mystl::uninitialized_relocate(i_begin, i_end, new_begin);
+        if (!was_inline) {
+            data_alloc().deallocate(i_begin, old_cap);
+        }
+        i_begin = new_begin;
+        i_end = new_begin + old_size;
+        i_cap = new_begin + new_cap;
+    }
+
+// ***************
+// steal
+// ***************
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::steal(small_vector &rhs) {
+        if (!rhs.is_inline()) {
+            i_begin = rhs.i_begin;
+            i_end = rhs.i_end;
+            i_cap = rhs.i_cap;
+        } else {
+            i_end = mystl::uninitialized_relocate(rhs.i_begin, rhs.i_end, i_begin);
+        }
+        rhs.reset_inline();
+    }
+
+// ***************
+// release
+// ***************
+    template<class T, size_t N, class Alloc>
+    void small_vector<T, N, Alloc>::release() noexcept {
+        data_alloc().destroy(i_begin, i_end);
+        if (!is_inline()) {
+            data_alloc().deallocate(i_begin, capacity());
+        }
+    }
+
+    template<class T, size_t N, class Alloc>
+    void swap(small_vector<T, N, Alloc> &lhs, small_vector<T, N, Alloc> &rhs) {
+        lhs.swap(rhs);
+    }
+
+    // erase(v, value) 删除所有等于 value 的元素，erase_if(v, pred) 删除所有 pred 为真的元素，一遍完成，返回删除的个数
+    template<class T, size_t N, class Alloc, class U>
+    typename small_vector<T, N, Alloc>::size_type erase(small_vector<T, N, Alloc> &v, const U &value) {
+        auto it = mystl::remove(v.begin(), v.end(), value);
+        const auto n = static_cast<typename small_vector<T, N, Alloc>::size_type>(v.end() - it);
+        v.erase(it, v.end());
+        return n;
+    }
+
+    template<class T, size_t N, class Alloc, class Pred>
+    typename small_vector<T, N, Alloc>::size_type erase_if(small_vector<T, N, Alloc> &v, Pred pred) {
+        auto it = mystl::remove_if(v.begin(), v.end(), pred);
+        const auto n = static_cast<typename small_vector<T, N, Alloc>::size_type>(v.end() - it);
+        v.erase(it, v.end());
+        return n;
+    }
+
+    // 使用多态内存资源的small_vector，polymorphic_allocator 定义在 memory_resource.h 中，使用时需要包含它
+    namespace pmr {
+        template<class T>
+        class polymorphic_allocator;
+
+        template<class T, size_t N>
+        using small_vector = mystl::small_vector<T, N, polymorphic_allocator<T>>;
+    }
+}
+
+#endif //STL_SMALL_VECTOR_H
@@ -0,0 +1,301 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_SPAN_H
+#define STL_SPAN_H
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+#include "hardening.h"
+
+// 这个头文件包含不拥有数据的连续视图 span<T, Extent>，只保存首地址和长度（静态长度时只保存首地址）
+// 可以由原生数组、指针区间以及提供 data()/size() 的容器（vector、small_vector）构造，
+// 函数参数使用 span 之后，不需要再传 const vector& 或者拷贝出一段子区间
+// 视图不延长数据的生命周期，容器重新分配之后原来的 span 失效，和指针一样
+// C++14 没有类模板实参推导，需要推导类型时使用 make_span
+
+namespace mystl
+{
+    // 长度在运行时才确定
+    constexpr size_t dynamic_extent = static_cast<size_t>(-1);
+
+    template <class T, size_t Extent = dynamic_extent>
+    class span;
+
+    namespace span_detail
+    {
+        // 静态长度只保存指针
+        template <class T, size_t Extent>
+        class span_storage
+        {
+        public:
+            constexpr span_storage() noexcept : data_(nullptr) {}
+            constexpr span_storage(T* data, size_t) noexcept : data_(data) {}
+
+            constexpr T* data() const noexcept { return data_; }
+            constexpr size_t size() const noexcept { return Extent; }
+
+        private:
+            T* data_;
+        };
+
+        template <class T>
+        class span_storage<T, dynamic_extent>
+        {
+        public:
+            constexpr span_storage() noexcept : data_(nullptr), size_(0) {}
+            constexpr span_storage(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+            constexpr T* data() const noexcept { return data_; }
+            constexpr size_t size() const noexcept { return size_; }
+
+        private:
+            T*     data_;
+            size_t size_;
+        };
+
+        template <class T>
+        struct is_span : public std::false_type {};
+
+        template <class T, size_t Extent>
+        struct is_span<span<T, Extent>> : public std::true_type {};
+
+        template <class...>
+        struct void_type { typedef void type; };
+
+        // Container 提供 data() 和 size()，并且 data() 指向的元素可以当作 T 使用（只允许加 const）
+        template <class Container, class T, class = void>
+        struct is_compatible_container : public std::false_type {};
+
+        template <class Container, class T>
+        struct is_compatible_container<Container, T, typename void_type<
+                decltype(std::declval<Container&>().data()),
+                decltype(std::declval<Container&>().size())>::type>
+                : public std::integral_constant<bool,
+                        !is_span<typename std::remove_cv<Container>::type>::value &&
+                        !std::is_array<Container>::value &&
+                        std::is_convertible<
+                                typename std::remove_pointer<decltype(std::declval<Container&>().data())>::type (*)[],
+                                T (*)[]>::value> {};
+
+        // subspan<Offset, Count>() 的长度
+        template <size_t Extent, size_t Offset, size_t Count>
+        struct subspan_extent
+        {
+            static constexpr size_t value = Count != dynamic_extent ? Count
+                    : (Extent != dynamic_extent ? Extent - Offset : dynamic_extent);
+        };
+    }
+
+    /*****************************************************************************************/
+    // span
+    /*****************************************************************************************/
+    template <class T, size_t Extent>
+    class span
+    {
+    public:
+        typedef T                                       element_type;
+        typedef typename std::remove_cv<T>::type        value_type;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef T*                                      pointer;
+        typedef const T*                                const_pointer;
+        typedef T&                                      reference;
+        typedef const T&                                const_reference;
+        typedef T*                                      iterator;
+        typedef mystl::reverse_iterator<iterator>       reverse_iterator;
+
+        static constexpr size_type extent = Extent;
+
+    private:
+        span_detail::span_storage<T, Extent> storage_;
+
+    public:
+        // 只有动态长度和长度为 0 的 span 可以默认构造
+        template <size_t E = Extent, typename std::enable_if<E == 0 || E == dynamic_extent, int>::type = 0>
+        constexpr span() noexcept {}
+
+        // 静态长度时 count 必须等于 Extent
+        constexpr span(pointer ptr, size_type count) : storage_(ptr, count)
+        {
+            MYSTL_HARDENING_ASSERT(Extent == dynamic_extent || count == Extent, "span size does not match its extent");
+        }
+
+        constexpr span(pointer first, pointer last) : storage_(first, static_cast<size_type>(last - first))
+        {
+            MYSTL_HARDENING_ASSERT(!(last < first), "span constructed from an invalid range");
+            MYSTL_HARDENING_ASSERT(Extent == dynamic_extent || static_cast<size_type>(last - first) == Extent,
+                                   "span size does not match its extent");
+        }
+
+        template <size_t N, typename std::enable_if<Extent == dynamic_extent || Extent == N, int>::type = 0>
+        constexpr span(element_type (&arr)[N]) noexcept : storage_(arr, N) {}
+
+        // 由 vector、small_vector 等连续容器构造，静态长度时需要显式构造
+        template <class Container, size_t E = Extent, typename std::enable_if<E == dynamic_extent &&
+                span_detail::is_compatible_container<Container, T>::value, int>::type = 0>
+        constexpr span(Container& c) : storage_(c.data(), c.size()) {}
+
+        template <class Container, size_t E = Extent, typename std::enable_if<E == dynamic_extent &&
+                span_detail::is_compatible_container<const Container, T>::value, int>::type = 0>
+        constexpr span(const Container& c) : storage_(c.data(), c.size()) {}
+
+        template <class Container, size_t E = Extent, typename std::enable_if<E != dynamic_extent &&
+                span_detail::is_compatible_container<Container, T>::value, int>::type = 0>
+        constexpr explicit span(Container& c) : span(c.data(), c.size()) {}
+
+        template <class Container, size_t E = Extent, typename std::enable_if<E != dynamic_extent &&
+                span_detail::is_compatible_container<const Container, T>::value, int>::type = 0>
+        constexpr explicit span(const Container& c) : span(c.data(), c.size()) {}
+
+        // span<U, N> 到 span<T, Extent> 的转换，比如 span<int> 到 span<const int>
+        template <class U, size_t N, typename std::enable_if<
+                (Extent == dynamic_extent || Extent == N) &&
+                std::is_convertible<U (*)[], T (*)[]>::value, int>::type = 0>
+        constexpr span(const span<U, N>& rhs) noexcept : storage_(rhs.data(), rhs.size()) {}
+
+        constexpr span(const span& rhs) noexcept = default;
+
+        span& operator=(const span& rhs) noexcept = default;
+
+        // 子视图
+        template <size_t Count>
+        constexpr span<T, Count> first() const
+        {
+            MYSTL_HARDENING_ASSERT(Count <= size(), "span::first() count out of range");
+            return span<T, Count>(data(), Count);
+        }
+
+        constexpr span<T, dynamic_extent> first(size_type count) const
+        {
+            MYSTL_HARDENING_ASSERT(count <= size(), "span::first() count out of range");
+            return span<T, dynamic_extent>(data(), count);
+        }
+
+        template <size_t Count>
+        constexpr span<T, Count> last() const
+        {
+            MYSTL_HARDENING_ASSERT(Count <= size(), "span::last() count out of range");
+            return span<T, Count>(data() + (size() - Count), Count);
+        }
+
+        constexpr span<T, dynamic_extent> last(size_type count) const
+        {
+            MYSTL_HARDENING_ASSERT(count <= size(), "span::last() count out of range");
+            return span<T, dynamic_extent>(data() + (size() - count), count);
+        }
+
+        template <size_t Offset, size_t Count = dynamic_extent>
+        constexpr span<T, span_detail::subspan_extent<Extent, Offset, Count>::value> subspan() const
+        {
+            MYSTL_HARDENING_ASSERT(Offset <= size() && (Count == dynamic_extent || Count <= size() - Offset),
+                                   "span::subspan() out of range");
+            return span<T, span_detail::subspan_extent<Extent, Offset, Count>::value>(
+                    data() + Offset, Count == dynamic_extent ? size() - Offset : Count);
+        }
+
+        constexpr span<T, dynamic_extent> subspan(size_type offset, size_type count = dynamic_extent) const
+        {
+            MYSTL_HARDENING_ASSERT(offset <= size() && (count == dynamic_extent || count <= size() - offset),
+                                   "span::subspan() out of range");
+            return span<T, dynamic_extent>(data() + offset, count == dynamic_extent ? size() - offset : count);
+        }
+
+        // 容量
+        constexpr size_type size() const noexcept { return storage_.size(); }
+
+        constexpr size_type size_bytes() const noexcept { return size() * sizeof(element_type); }
+
+        constexpr bool empty() const noexcept { return size() == 0; }
+
+        // 访问元素
+        constexpr reference operator[](size_type n) const
+        {
+            MYSTL_HARDENING_ASSERT(n < size(), "span::operator[] index out of range");
+            return data()[n];
+        }
+
+        constexpr reference front() const
+        {
+            MYSTL_HARDENING_ASSERT(!empty(), "span::front() on empty span");
+            return data()[0];
+        }
+
+        constexpr reference back() const
+        {
+            MYSTL_HARDENING_ASSERT(!empty(), "span::back() on empty span");
+            return data()[size() - 1];
+        }
+
+        constexpr pointer data() const noexcept { return storage_.data(); }
+
+        // 迭代器
+        constexpr iterator begin() const noexcept { return data(); }
+
+        constexpr iterator end() const noexcept { return data() + size(); }
+
+        reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+
+        reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+    };
+
+    template <class T, size_t Extent>
+    constexpr size_t span<T, Extent>::extent;
+
+    // 以字节的形式查看，交给 I/O 使用
+    template <class T, size_t Extent>
+    span<const unsigned char, Extent == dynamic_extent ? dynamic_extent : Extent * sizeof(T)>
+    as_bytes(span<T, Extent> s) noexcept
+    {
+        return span<const unsigned char, Extent == dynamic_extent ? dynamic_extent : Extent * sizeof(T)>(
+                reinterpret_cast<const unsigned char*>(s.data()), s.size_bytes());
+    }
+
+    template <class T, size_t Extent, typename std::enable_if<!std::is_const<T>::value, int>::type = 0>
+    span<unsigned char, Extent == dynamic_extent ? dynamic_extent : Extent * sizeof(T)>
+    as_writable_bytes(span<T, Extent> s) noexcept
+    {
+        return span<unsigned char, Extent == dynamic_extent ? dynamic_extent : Extent * sizeof(T)>(
+                reinterpret_cast<unsigned char*>(s.data()), s.size_bytes());
+    }
+
+    // make_span 推导 span 的类型
+    template <class T>
+    constexpr span<T> make_span(T* ptr, size_t count)
+    {
+        return span<T>(ptr, count);
+    }
+
+    template <class T>
+    constexpr span<T> make_span(T* first, T* last)
+    {
+        return span<T>(first, last);
+    }
+
+    template <class T, size_t N>
+    constexpr span<T, N> make_span(T (&arr)[N]) noexcept
+    {
+        return span<T, N>(arr);
+    }
+
+    template <class Container>
+    constexpr span<typename std::remove_pointer<decltype(std::declval<Container&>().data())>::type>
+    make_span(Container& c)
+    {
+        return span<typename std::remove_pointer<decltype(std::declval<Container&>().data())>::type>(c);
+    }
+
+    template <class Container>
+    constexpr span<typename std::remove_pointer<decltype(std::declval<const Container&>().data())>::type>
+    make_span(const Container& c)
+    {
+        return span<typename std::remove_pointer<decltype(std::declval<const Container&>().data())>::type>(c);
+    }
+}
+
+#endif //STL_SPAN_H
@@ -0,0 +1,212 @@
+//
+// Created by shilinkun on 2026/10/18.
+//
+
+#ifndef STL_TRACE_H
+#define STL_TRACE_H
+#pragma once
+
+// 这个头文件提供容器热路径上的追踪钩子，在编译期选择是否开启
+// 默认（没有定义 MYSTL_TRACE）时，所有的宏都展开为空语句，release 版本没有任何开销
+// 定义 MYSTL_TRACE 之后，每个事件 (op, 容器地址, 大小, 耗时周期) 写入当前线程私有的环形缓冲区，
+// 写入只有一次 relaxed load 和一次 release store，不加锁、不阻塞，之后可以用 trace_dump 输出
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef MYSTL_TRACE
+
+#include <atomic>
+#include <cstdio>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// 每个线程的环形缓冲区能保存的事件数目，必须是 2 的幂
+#ifndef MYSTL_TRACE_BUF_SIZE
+#define MYSTL_TRACE_BUF_SIZE 4096
+#endif
+
+namespace mystl
+{
+    static_assert((MYSTL_TRACE_BUF_SIZE & (MYSTL_TRACE_BUF_SIZE - 1)) == 0,
+                  "MYSTL_TRACE_BUF_SIZE must be a power of 2");
+
+    // 一条追踪事件，op 必须是字符串字面量（静态存储期），这样记录时不需要拷贝字符串
+    struct trace_event
+    {
+        const char*  op;         // 操作名
+        const void*  container;  // 容器（或对象）地址
+        size_t       size;       // 操作结束时的大小
+        uint64_t     cycles;     // 操作耗时的周期数，单点事件为 0
+    };
+
+    // 读取时间戳计数器，x86 下使用 rdtsc，其它平台退化为 steady_clock 的纳秒数
+    inline uint64_t trace_cycles() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /*****************************************************************************************/
+    // trace_ring
+    // 单写者的环形缓冲区，只有所属线程会写入，写满之后覆盖最旧的事件
+    /*****************************************************************************************/
+    class trace_ring
+    {
+    public:
+        static constexpr size_t capacity = MYSTL_TRACE_BUF_SIZE;
+
+        trace_ring() noexcept : head_(0), next_(nullptr) {}
+
+        void record(const char* op, const void* container, size_t size, uint64_t cycles) noexcept
+        {
+            const size_t h = head_.load(std::memory_order_relaxed);
+            buf_[h & (capacity - 1)] = trace_event{op, container, size, cycles};
+            head_.store(h + 1, std::memory_order_release);
+        }
+
+        // 一共写入过多少条事件（包括被覆盖的）
+        size_t total() const noexcept
+        {
+            return head_.load(std::memory_order_acquire);
+        }
+
+        // 从旧到新遍历缓冲区中仍然保留的事件
+        template <class Func>
+        void for_each(Func f) const
+        {
+            const size_t h = total();
+            const size_t n = h < capacity ? h : capacity;
+            for (size_t i = h - n; i != h; ++i)
+            {
+                f(buf_[i & (capacity - 1)]);
+            }
+        }
+
+        void clear() noexcept
+        {
+            head_.store(0, std::memory_order_release);
+        }
+
+        const trace_ring* next() const noexcept { return next_; }
+
+        void set_next(trace_ring* next) noexcept { next_ = next; }
+
+    private:
+        trace_event          buf_[capacity];
+        std::atomic<size_t>  head_;
+        trace_ring*          next_;  // 所有线程的缓冲区串成一个单链表，用于 trace_dump_all
+    };
+
+    // 所有线程缓冲区组成的链表头
+    inline std::atomic<trace_ring*>& trace_ring_list() noexcept
+    {
+        static std::atomic<trace_ring*> head{nullptr};
+        return head;
+    }
+
+    // 当前线程的缓冲区，第一次使用时创建并用 CAS 挂到全局链表上
+    // 缓冲区故意不释放，这样线程退出之后仍然可以 dump 它的事件
+    inline trace_ring& this_thread_trace() noexcept
+    {
+        static thread_local trace_ring* ring = nullptr;
+        if (ring == nullptr)
+        {
+            ring = new trace_ring();
+            auto& list = trace_ring_list();
+            auto old_head = list.load(std::memory_order_relaxed);
+            do
+            {
+                ring->set_next(old_head);
+            } while (!list.compare_exchange_weak(old_head, ring,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
+        }
+        return *ring;
+    }
+
+    inline void trace_record(const char* op, const void* container, size_t size,
+                             uint64_t cycles = 0) noexcept
+    {
+        this_thread_trace().record(op, container, size, cycles);
+    }
+
+    // 把一个缓冲区中的事件输出到 out
+    inline void trace_dump(const trace_ring& ring, FILE* out = stderr)
+    {
+        ring.for_each([out](const trace_event& e) {
+            std::fprintf(out, "%-32s %p size=%zu cycles=%llu\n", e.op, e.container, e.size,
+                         static_cast<unsigned long long>(e.cycles));
+        });
+    }
+
+    // 输出当前线程的事件
+    inline void trace_dump(FILE* out = stderr)
+    {
+        trace_dump(this_thread_trace(), out);
+    }
+
+    // 输出所有线程的事件，应该在其它线程不再写入的时候调用（比如退出前或者诊断暂停时）
+    inline void trace_dump_all(FILE* out = stderr)
+    {
+        for (const trace_ring* r = trace_ring_list().load(std::memory_order_acquire); r != nullptr; r = r->next())
+        {
+            std::fprintf(out, "---- trace ring %p ----\n", static_cast<const void*>(r));
+            trace_dump(*r, out);
+        }
+    }
+
+    /*****************************************************************************************/
+    // trace_scope
+    // 在作用域开始时读取时间戳，结束时记录一条带耗时的事件，size 在结束时才求值
+    /*****************************************************************************************/
+    template <class SizeFunc>
+    class trace_scope
+    {
+    public:
+        trace_scope(const char* op, const void* container, SizeFunc size) noexcept
+                : op_(op), container_(container), size_(size), start_(trace_cycles()) {}
+
+        ~trace_scope()
+        {
+            trace_record(op_, container_, static_cast<size_t>(size_()), trace_cycles() - start_);
+        }
+
+    private:
+        const char* op_;
+        const void* container_;
+        SizeFunc    size_;
+        uint64_t    start_;
+    };
+
+    template <class SizeFunc>
+    trace_scope<SizeFunc> make_trace_scope(const char* op, const void* container, SizeFunc size) noexcept
+    {
+        return trace_scope<SizeFunc>(op, container, size);
+    }
+}
+
+// 记录一个单点事件
+#define MYSTL_TRACE_EVENT(op, container, size) \
+    mystl::trace_record((op), static_cast<const void*>(container), static_cast<size_t>(size))
+
+// 记录当前作用域的耗时，size 表达式在作用域结束时求值，一个作用域中只能使用一次
+#define MYSTL_TRACE_SCOPE(op, container, size) \
+    auto mystl_trace_scope_ = mystl::make_trace_scope((op), static_cast<const void*>(container), \
+                                                      [&]() { return (size); })
+
+#else
+
+#define MYSTL_TRACE_EVENT(op, container, size) ((void)0)
+#define MYSTL_TRACE_SCOPE(op, container, size) ((void)0)
+
+#endif // MYSTL_TRACE
+
+#endif //STL_TRACE_H
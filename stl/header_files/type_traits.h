@@ -46,4 +46,13 @@ namespace mystl
     template <class T1, class T2>
     struct is_pair<mystl::pair<T1, T2>> : mystl::m_true_type {};
 
+    // is_trivially_relocatable
+    // 把对象按位复制到新的地址，并且不再析构原来的对象，效果和 移动构造 + 析构原对象 相同的类型
+    // 默认只有可以平凡复制的类型，只持有指向外部资源的指针的句柄类（比如 unique_ptr）可以由用户特化为 true：
+    //     template <> struct mystl::is_trivially_relocatable<my_handle> : mystl::m_true_type {};
+    // 持有指向自身内部的指针的类型不能特化，包括 libstdc++ 的 std::string（指向自己的短字符串缓冲区）：
+    // 按位搬移之后指针仍然指向原来的地址
+    template <class T>
+    struct is_trivially_relocatable : mystl::m_bool_constant<std::is_trivially_copyable<T>::value> {};
+
 } // namespace mystl
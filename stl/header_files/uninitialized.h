@@ -7,12 +7,34 @@
 
 #endif //STL_UNINITIALIZED_H
 #pragma once
+#include <cstring>
 #include "algobase.h"
+#include "construct.h"
+#include "type_traits.h"
+
+#ifdef MYSTL_PARALLEL_FILL
+#include <thread>
+#endif
 
 // 这个头文件用于对未初始化空间构造元素
 
+// 定义 MYSTL_PARALLEL_FILL 之后，可以平凡复制的元素的 uninitialized_fill_n 在不小于 MYSTL_PARALLEL_FILL_THRESHOLD 字节时
+// 分给多个线程填充，每个线程写入连续的一段，页面按首次访问（first-touch）分配在写入线程所在的 NUMA 节点上
+#ifndef MYSTL_PARALLEL_FILL_THRESHOLD
+#define MYSTL_PARALLEL_FILL_THRESHOLD (16 * 1024 * 1024)
+#endif
+
 namespace mystl
 {
+    // 目标是未初始化的空间，只有构造和赋值都是平凡的类型才能用赋值（memmove）代替构造，
+    // 只看赋值时，自定义了拷贝构造、析构而赋值是默认的类型会得到没有构造过的对象
+    template <class T>
+    struct uninit_copy_by_assign : std::integral_constant<bool,
+            std::is_trivially_copy_constructible<T>::value && std::is_trivially_copy_assignable<T>::value> {};
+
+    template <class T>
+    struct uninit_move_by_assign : std::integral_constant<bool,
+            std::is_trivially_move_constructible<T>::value && std::is_trivially_move_assignable<T>::value> {};
 
     /*****************************************************************************************/
     // uninitialized_copy
@@ -41,6 +63,7 @@ namespace mystl
         {
             for (; result != cur; ++result)
                 mystl::destroy(&*result);
+            throw;
         }
         return cur;
     }
@@ -49,7 +72,7 @@ namespace mystl
     ForwardIter uninitialized_copy(InputIter first, InputIter last, ForwardIter result)
     {
         return mystl::unchecked_uninit_copy(first, last, result,
-                                            std::is_trivially_copy_assignable<
+                                            mystl::uninit_copy_by_assign<
                                                     typename iterator_traits<ForwardIter>::
                                                     value_type>{});
     }
@@ -80,6 +103,7 @@ namespace mystl
         {
             for (;first != cur; ++first)
                 mystl::destroy(&*first);
+            throw;
         }
     }
 
@@ -87,7 +111,7 @@ namespace mystl
     void  uninitialized_fill(ForwardIter first, ForwardIter last, const T& value)
     {
         mystl::unchecked_uninit_fill(first, last, value,
-                                     std::is_trivially_copy_assignable<
+                                     mystl::uninit_copy_by_assign<
                                              typename iterator_traits<ForwardIter>::
                                              value_type>{});
     }
@@ -119,15 +143,68 @@ namespace mystl
             {
                 mystl::destroy(&*first);
             }
+            throw;
         }
         return cur;
 
     }
+#ifdef MYSTL_PARALLEL_FILL
+    // 多线程填充 [first, first + n)，每段的长度上调到整页，线程创建失败时这一段由当前线程填充
+    template <class Tp, class Size, class T>
+    Tp* parallel_fill_n(Tp* first, Size n, const T& value)
+    {
+        enum { MAX_THREADS = 64 };
+        enum { PAGE_BYTES = 4096 };
+        const size_t count = static_cast<size_t>(n);
+        size_t nthreads = std::thread::hardware_concurrency();
+        if (count * sizeof(Tp) < static_cast<size_t>(MYSTL_PARALLEL_FILL_THRESHOLD) || nthreads <= 1)
+        {
+            return mystl::fill_n(first, n, value);
+        }
+        if (nthreads > static_cast<size_t>(MAX_THREADS))
+        {
+            nthreads = MAX_THREADS;
+        }
+        const size_t page_elems = sizeof(Tp) < static_cast<size_t>(PAGE_BYTES) ? PAGE_BYTES / sizeof(Tp) : 1;
+        size_t chunk = (count + nthreads - 1) / nthreads;
+        chunk = (chunk + page_elems - 1) / page_elems * page_elems;
+
+        std::thread workers[MAX_THREADS];
+        size_t started = 0;
+        for (size_t begin = chunk; begin < count; begin += chunk)
+        {
+            const size_t len = count - begin < chunk ? count - begin : chunk;
+            Tp* part = first + begin;
+            try
+            {
+                workers[started] = std::thread([part, len, value]() { mystl::fill_n(part, len, value); });
+                ++started;
+            }
+            catch (...)
+            {
+                mystl::fill_n(part, len, value);
+            }
+        }
+        mystl::fill_n(first, count < chunk ? count : chunk, value);
+        for (size_t i = 0; i < started; ++i)
+        {
+            workers[i].join();
+        }
+        return first + count;
+    }
+
+    template <class Tp, class Size, class T>
+    Tp* unchecked_uninit_fill_n(Tp* first, Size n, const T& value, std::true_type)
+    {
+        return mystl::parallel_fill_n(first, n, value);
+    }
+#endif
+
     template <class ForwardIter, class Size, class T>
     ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value)
     {
         return mystl::unchecked_uninit_fill_n(first, n, value,
-                                              std::is_trivially_copy_assignable<
+                                              mystl::uninit_copy_by_assign<
                                                       typename iterator_traits<ForwardIter>::
                                                       value_type>{});
     }
@@ -158,6 +235,7 @@ namespace mystl
         catch (...)
         {
             mystl::destroy(result, cur);
+            throw;
         }
         return cur;
     }
@@ -166,7 +244,7 @@ namespace mystl
     ForwardIter uninitialized_move(InputIter first, InputIter last, ForwardIter result)
     {
         return mystl::unchecked_uninit_move(first, last, result,
-                                            std::is_trivially_move_assignable<
+                                            mystl::uninit_move_by_assign<
                                                     typename iterator_traits<InputIter>::
                                                     value_type>{});
     }
@@ -208,9 +286,54 @@ namespace mystl
     ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result)
     {
         return mystl::unchecked_uninit_move_n(first, n, result,
-                                              std::is_trivially_move_assignable<
+                                              mystl::uninit_move_by_assign<
                                                       typename iterator_traits<InputIter>::
                                                       value_type>{});
     }
 
+
+    /*****************************************************************************************/
+    // uninitialized_relocate
+    // 把 [first, last) 上的对象搬到以 result 为起始处的未初始化空间，之后 [first, last) 变为未初始化的空间，返回搬移结束的位置
+    // 可以按位搬移（is_trivially_relocatable）的类型只做一次 memmove，这时两段区间可以重叠
+    // 其它类型先全部移动构造，再析构原来的对象，两段区间不能重叠
+    /*****************************************************************************************/
+    template <class T>
+    T* unchecked_uninit_relocate(T* first, T* last, T* result, std::true_type) noexcept
+    {
+        const size_t n = static_cast<size_t>(last - first);
+        if (n != 0)
+        {
+            std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+        }
+        return result + n;
+    }
+
+    template <class T>
+    T* unchecked_uninit_relocate(T* first, T* last, T* result, std::false_type)
+    {
+        T* cur = result;
+        try
+        {
+            for (T* it = first; it != last; ++it, ++cur)
+            {
+                mystl::construct(cur, mystl::move(*it));
+            }
+        }
+        catch (...)
+        {
+            mystl::destroy(result, cur);
+            throw;
+        }
+        mystl::destroy(first, last);
+        return cur;
+    }
+
+    template <class T>
+    T* uninitialized_relocate(T* first, T* last, T* result)
+    {
+        return mystl::unchecked_uninit_relocate(first, last, result,
+                                                std::integral_constant<bool,
+                                                        mystl::is_trivially_relocatable<T>::value>{});
+    }
 }
@@ -8,6 +8,7 @@
 #endif //STL_UTILS_H
 #pragma once
 #include <cstddef>
+#include <type_traits>
 
 // 这个文件包含一些通用工具，包括 move, forward, swap 等函数，以及 pair 等
 
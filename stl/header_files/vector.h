@@ -15,91 +15,169 @@
 #include "uninitialized.h"
 #include "iterator.h"
 #include "memory.h"
+#include "trace.h"
+#include "growth_policy.h"
+#include "hardening.h"
 
 #include <cassert>
+#include <stdexcept>
 #include <iostream>
 
 
 namespace mystl {
 
-    template<class T>
-    class vector {
+    // Alloc 可以是任意满足 allocator 接口的分配器，容器内部通过 rebind 得到 T 的分配器并保存一个实例
+    // Growth 为容量增长策略，见 growth_policy.h
+    template<class T, class Alloc = mystl::allocator<T>, class Growth = mystl::default_growth>
+    class vector : private mystl::alloc_holder<typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>> {
         static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in mystl");
     public:
-        typedef mystl::allocator<T> allocator_type;
-        typedef mystl::allocator<T> data_allocator;
+        typedef Alloc allocator_type;
+        typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> data_allocator;
+        typedef mystl::allocator_traits<data_allocator> alloc_traits;
+        typedef Growth growth_policy;
 
 
         // typedef typename 一般使用在重命名中有::的
-        typedef typename allocator_type::value_type value_type;             //	typedef T value_type;
-        typedef typename allocator_type::pointer pointer;                // typedef T* pointer;
-        typedef typename allocator_type::const_pointer const_pointer;          //	typedef const T* const_pointer;
-        typedef typename allocator_type::reference reference;              // typedef T& reference;
-        typedef typename allocator_type::const_reference const_reference;        // typedef const T& const_reference;
-        typedef typename allocator_type::size_type size_type;              //	typedef size_t(unsigned int) size_type;
-        typedef typename allocator_type::difference_type difference_type;        //	typedef ptrdiff_t difference_type;
-
+        typedef typename data_allocator::value_type value_type;             //	typedef T value_type;
+        typedef typename data_allocator::pointer pointer;                // typedef T* pointer;
+        typedef typename data_allocator::const_pointer const_pointer;          //	typedef const T* const_pointer;
+        typedef typename data_allocator::reference reference;              // typedef T& reference;
+        typedef typename data_allocator::const_reference const_reference;        // typedef const T& const_reference;
+        typedef typename data_allocator::size_type size_type;              //	typedef size_t(unsigned int) size_type;
+        typedef typename data_allocator::difference_type difference_type;        //	typedef ptrdiff_t difference_type;
+
+#if MYSTL_HARDENING_LEVEL >= 2
+        // 带检查的迭代器，见 hardening.h
+        typedef mystl::checked_iterator<value_type, vector> iterator;
+        typedef mystl::checked_iterator<const value_type, vector> const_iterator;
+#else
         typedef value_type* iterator;               // T*
         typedef const value_type* const_iterator;         // const T*
+#endif
         typedef mystl::reverse_iterator<iterator> reverse_iterator;
         typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-        allocator_type get_allocator() { return data_allocator(); }
+        allocator_type get_allocator() const { return allocator_type(data_alloc()); }
 
     private:
-        iterator i_begin;   //使用空间的头部
-        iterator i_end;     //使用空间的尾部
-        iterator i_cap;     //占用空间的尾部
+        typedef mystl::alloc_holder<data_allocator> alloc_base;
+
+        data_allocator &data_alloc() noexcept { return this->get_alloc(); }
+
+        const data_allocator &data_alloc() const noexcept { return this->get_alloc(); }
+
+        pointer i_begin;   //使用空间的头部
+        pointer i_end;     //使用空间的尾部
+        pointer i_cap;     //占用空间的尾部
+
+#if MYSTL_HARDENING_LEVEL >= 2
+        size_t generation_ = 0;  // 迭代器的代数，使全部迭代器失效的操作让它加一
+
+        template<class, class> friend class mystl::checked_iterator;
+
+        const value_type *checked_begin() const noexcept { return i_begin; }
+
+        const value_type *checked_end() const noexcept { return i_end; }
+
+        size_t checked_generation() const noexcept { return generation_; }
+
+        void invalidate_iterators() noexcept { ++generation_; }
+
+        iterator to_iter(pointer p) noexcept { return iterator(p, this); }
+
+        const_iterator to_iter(const_pointer p) const noexcept { return const_iterator(p, this); }
+
+        // 传入的位置必须是这个 vector 的、没有失效的迭代器
+        pointer to_ptr(const_iterator it) const {
+            it.check_owner(this);
+            return const_cast<pointer>(it.base());
+        }
+#else
+        // 迭代器就是指针，这几个函数什么都不做
+        void invalidate_iterators() noexcept {}
+
+        iterator to_iter(pointer p) noexcept { return p; }
+
+        const_iterator to_iter(const_pointer p) const noexcept { return p; }
+
+        pointer to_ptr(const_iterator it) const noexcept { return const_cast<pointer>(it); }
+#endif
 
     public:
 
-        // 构造函数，cap为16
+        // 构造函数，不分配内存，三个指针都为空，第一次插入时才按增长策略分配（默认16个）
         // noexcept ：等价于noexcept(true) 表示该函数不抛出异常，noexcept(false)表示可以抛出异常
-        vector() noexcept {
-            std::cout << "vector()" << std::endl;
-            try_init();
+        vector() noexcept: i_begin(nullptr), i_end(nullptr), i_cap(nullptr) {
+            MYSTL_TRACE_SCOPE("vector()", this, size());
         }
 
-        // 构造函数，cap为16，end-begin=n
+        // 使用指定的分配器实例，有状态的分配器（比如 arena）通过这种方式传入
+        explicit vector(const allocator_type &alloc) noexcept
+                : alloc_base(data_allocator(alloc)), i_begin(nullptr), i_end(nullptr), i_cap(nullptr) {
+            MYSTL_TRACE_SCOPE("vector(const allocator_type& alloc)", this, size());
+        }
+
+        // 构造函数，cap为增长策略的最小容量（默认16），end-begin=n，元素由分配器的 construct(p) 构造（默认为值初始化）
         // explicit使用在单参数的构造函数中，防止隐式转换，若加了explicit，则
         // 这种定义是错误的 vector<int> a = 10;
         // 若没加explicit，则是正确的，程序会自动判断=右边的值是否可以作为构造函数的参数，若可以，则将
         // 右边的值作为构造函数的参数传入，调用构造函数，所以一般单参数的构造函数会加上explicit
-        explicit vector(size_type n) noexcept {
-            std::cout << "vector(size_type n)" << std::endl;
-            fill_init(n, value_type());
+        explicit vector(size_type n, const allocator_type &alloc = allocator_type()) noexcept
+                : alloc_base(data_allocator(alloc)) {
+            MYSTL_TRACE_SCOPE("vector(size_type n)", this, size());
+            init_space(0, init_cap(n));
+            default_append(n);
         }
 
-        // 构造函数，cap为16，end-begin=n，并初始化值为value
-        vector(size_type n, const value_type &value) noexcept {
-            std::cout << "vector(size_type n, const value_type& value)" << std::endl;
+        // 构造函数，cap为增长策略的最小容量（默认16），end-begin=n，并初始化值为value
+        vector(size_type n, const value_type &value, const allocator_type &alloc = allocator_type()) noexcept
+                : alloc_base(data_allocator(alloc)) {
+            MYSTL_TRACE_SCOPE("vector(size_type n, const value_type& value)", this, size());
             fill_init(n, value);
         }
 
         // 构造函数vector<int>v2(v1.begin(),v1.end())
         template<class Iter, typename std::enable_if<mystl::is_input_iterator<Iter>::value, int>::type= 0>
-        vector(Iter first, Iter last) {
-            std::cout << "vector(Iter first, Iter last)" << std::endl;
+        vector(Iter first, Iter last, const allocator_type &alloc = allocator_type())
+                : alloc_base(data_allocator(alloc)) {
+            MYSTL_TRACE_SCOPE("vector(Iter first, Iter last)", this, size());
             assert(!(last < first));
             range_init(first, last);
         }
 
         //  移动构造函数,所以在这个函数中，一定要让传入的参数的值在move之后丢弃掉，且需要加上noexcept
-        vector(vector &&rhs) noexcept: i_begin(rhs.i_begin), i_end(rhs.i_end), i_cap(rhs.i_cap) {
-            std::cout << "vector(vector&& rhs)" << std::endl;
+        // 分配器随数据一起移动过来
+        vector(vector &&rhs) noexcept: alloc_base(mystl::move(rhs.data_alloc())),
+                                       i_begin(rhs.i_begin), i_end(rhs.i_end), i_cap(rhs.i_cap) {
+            MYSTL_TRACE_SCOPE("vector(vector&& rhs)", this, size());
             rhs.i_begin = nullptr;
             rhs.i_end = nullptr;
             rhs.i_cap = nullptr;
         }
 
-        // 拷贝构造
-        vector(const vector &rhs) {
-            std::cout << "vector(const vector &rhs)" << std::endl;
+        // 拷贝构造，分配器由 select_on_container_copy_construction 决定
+        vector(const vector &rhs)
+                : alloc_base(alloc_traits::select_on_container_copy_construction(rhs.data_alloc())) {
+            MYSTL_TRACE_SCOPE("vector(const vector& rhs)", this, size());
             range_init(rhs.i_begin, rhs.i_end);
         }
 
     private:
-        void try_init() noexcept;
+        struct no_init_tag {};
+
+        // 只分配可以容纳n个元素的空间，size 为 0，由调用者构造元素之后再设置 i_end
+        vector(size_type n, const allocator_type &alloc, no_init_tag) : alloc_base(data_allocator(alloc)) {
+            init_space(0, init_cap(n));
+        }
+
+        // 放 n 个元素时第一次分配的容量，不小于增长策略的最小容量，n 为 0 时不分配
+        static size_type init_cap(size_type n) noexcept {
+            if (n == 0) {
+                return 0;
+            }
+            return Growth::fit(mystl::max(static_cast<size_type>(Growth::min_capacity), n), sizeof(value_type));
+        }
 
         void fill_init(size_type n, const value_type &value);
 
@@ -112,20 +190,20 @@ namespace mystl {
     public:
         // 正向迭代器（可读可写）
         iterator begin() noexcept {
-            return i_begin;
+            return to_iter(i_begin);
         }
 
         // 不加const，就会和上面的重载冲突，因为只有返回值不一样，不能构成重载
         const_iterator begin() const noexcept {
-            return i_begin;
+            return to_iter(i_begin);
         }
 
         iterator end() noexcept {
-            return i_end;
+            return to_iter(i_end);
         }
 
         const_iterator end() const noexcept {
-            return i_end;
+            return to_iter(i_end);
         }
 
         // 反向迭代器（可读可写）
@@ -133,7 +211,7 @@ namespace mystl {
             return reverse_iterator(end());
         }
 
-        const reverse_iterator rbegin() const noexcept {
+        const_reverse_iterator rbegin() const noexcept {
             return const_reverse_iterator(end());
         }
 
@@ -141,7 +219,7 @@ namespace mystl {
             return reverse_iterator(begin());
         }
 
-        const reverse_iterator rend() const noexcept {
+        const_reverse_iterator rend() const noexcept {
             return const_reverse_iterator(begin());
         }
 
@@ -187,16 +265,41 @@ namespace mystl {
         // reverse(n)将大小转为n个
         void reverse(size_type n);
 
+        // reserve(n) 保证容量至少为 n，只会扩大，实际容量由增长策略的 fit 决定
+        void reserve(size_type n);
+
+        // shrink_to_fit 把容量缩小到增长策略的 fit(size())，没有元素时释放全部空间
+        void shrink_to_fit();
+
         reference front() {
-            assert(!empty());
+            MYSTL_HARDENING_ASSERT(!empty(), "vector::front() on empty vector");
+            return *i_begin;
+        }
+
+        const_reference front() const {
+            MYSTL_HARDENING_ASSERT(!empty(), "vector::front() on empty vector");
             return *i_begin;
         }
 
         reference back() {
-            assert(!empty());
+            MYSTL_HARDENING_ASSERT(!empty(), "vector::back() on empty vector");
             return *(i_end - 1);
         }
 
+        const_reference back() const {
+            MYSTL_HARDENING_ASSERT(!empty(), "vector::back() on empty vector");
+            return *(i_end - 1);
+        }
+
+        // data() 元素所在的连续空间，没有分配时为空指针，span 通过它构造
+        pointer data() noexcept {
+            return i_begin;
+        }
+
+        const_pointer data() const noexcept {
+            return i_begin;
+        }
+
         /*
          * emplace操作是C++11新特性，新引入的的三个成员emlace_front、empace 和 emplace_back,这些操作构造而不是拷贝元素到容器中，
          * 这些操作分别对应push_front、insert 和push_back，允许我们将元素放在容器头部、一个指定的位置和容器尾部。
@@ -222,7 +325,6 @@ namespace mystl {
 
         // 移动构造(若传入的value是右值，比如临时变量)
         iterator insert(const_iterator cur, value_type &&value) {
-            std::cout << "insert(const_iterator cur,value_type&& value)" << std::endl;
             // mystl::move -->  std::move实际就是可以得到传入参数的右值，不管传入的参数是右值还是左值
             // 右值：只能放在=右边
             // 左值：两边都可以放
@@ -230,10 +332,37 @@ namespace mystl {
         }
         // insert(pos,n,value)
 
-        iterator fill_insert(iterator cur, size_type n, const value_type &value);
+        pointer fill_insert(pointer cur, size_type n, const value_type &value);
 
         iterator insert(const_iterator cur, size_type n, const value_type &value) {
-            return fill_insert(const_cast<iterator>(cur), n, value);
+            pointer pos = to_ptr(cur);
+            MYSTL_HARDENING_ASSERT(i_begin <= pos && pos <= i_end, "vector::insert position out of range");
+            return to_iter(fill_insert(pos, n, value));
+        }
+
+        // insert(pos,first,last) 在 pos 处插入 [first, last)，[first, last) 不能是这个 vector 中的元素
+        // 前向迭代器只检查一次容量、只后移一次尾部元素，input 迭代器先逐个追加到尾部再旋转到 pos
+        template<class Iter, typename std::enable_if<mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator cur, Iter first, Iter last) {
+            pointer pos = to_ptr(cur);
+            MYSTL_HARDENING_ASSERT(i_begin <= pos && pos <= i_end, "vector::insert position out of range");
+            return to_iter(range_insert(pos, first, last, iterator_category(first)));
+        }
+
+        iterator insert(const_iterator cur, std::initializer_list<value_type> ilist) {
+            return insert(cur, ilist.begin(), ilist.end());
+        }
+
+        // append_range 把 [first, last) 追加到尾部，批量追加时代替逐个 push_back
+        template<class Iter, typename std::enable_if<mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        void append_range(Iter first, Iter last) {
+            range_insert(i_end, first, last, iterator_category(first));
+        }
+
+        // 追加任意提供 begin()/end() 的容器中的元素
+        template<class Range>
+        void append_range(const Range &range) {
+            append_range(range.begin(), range.end());
         }
 
         template<class... Args>
@@ -248,8 +377,11 @@ namespace mystl {
 
         // resize
         void resize(size_type new_size, const value_type &value);
-        // 默认插入0
-        void resize(size_type new_size){return resize(new_size,value_type());};
+        // 新增的元素由分配器的 construct(p) 构造：allocator 值初始化（int 为 0），default_init_allocator 默认初始化
+        void resize(size_type new_size);
+
+        // resize_uninitialized 新增的元素不初始化，由调用者随后直接写入（比如作为 read() 的缓冲区），只能用于平凡的类型
+        void resize_uninitialized(size_type new_size);
 
         // reverse(begin,end)反转vector
         void reverse(){mystl::reverse(begin(),end());};
@@ -259,22 +391,39 @@ namespace mystl {
         // ********************************************操作符重载
         // []
         reference operator[](size_type n) {
-            assert(n < size());
+            MYSTL_HARDENING_ASSERT(n < size(), "vector::operator[] index out of range");
             return *(i_begin + n);
         }
 
-        // at
+        const_reference operator[](size_type n) const {
+            MYSTL_HARDENING_ASSERT(n < size(), "vector::operator[] index out of range");
+            return *(i_begin + n);
+        }
+
+        // at 越界时抛出 std::out_of_range
         reference at(size_type n) {
-            assert(n < size());
-            return (*this)[n]; //注意这里的括号
+            if (n >= size()) {
+                throw std::out_of_range("vector<T>::at() subscript out of range");
+            }
+            return *(i_begin + n);
+        }
+
+        const_reference at(size_type n) const {
+            if (n >= size()) {
+                throw std::out_of_range("vector<T>::at() subscript out of range");
+            }
+            return *(i_begin + n);
         }
 
         // =，必须要加&，否则赋值后，不会改变原来的值
         vector &operator=(const vector &rhs); // 拷贝赋值
-        vector &operator=(vector &&rhs);      // 移动赋值
+        // 移动赋值，分配器不传播并且可能不相等时需要分配内存，不是 noexcept
+        vector &operator=(vector &&rhs) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                                 alloc_traits::is_always_equal::value);
         // 使用{}赋值
-        vector(std::initializer_list<value_type> ilist) {
-            std::cout << "vector(std::initializer_list<value_type> ilist)" << std::endl;
+        vector(std::initializer_list<value_type> ilist, const allocator_type &alloc = allocator_type())
+                : alloc_base(data_allocator(alloc)) {
+            MYSTL_TRACE_SCOPE("vector(std::initializer_list)", this, size());
             range_init(ilist.begin(), ilist.end());
         }
 
@@ -282,20 +431,62 @@ namespace mystl {
 
 
         // ****************************************vector相关辅助函数
-        // swap 将自己和rhs交换
+        // swap 将自己和rhs交换，propagate_on_container_swap 为真时连同分配器一起交换
         void swap(vector &rhs) noexcept;
 
+    private:
+        // 交换数据和分配器，用于赋值操作中和临时对象交换
+        void swap_all(vector &rhs) noexcept;
+
+    public:
+
         //收回空间
-        void destrop_and_recover(iterator first, iterator last, size_type n);
+        void destrop_and_recover(pointer first, pointer last, size_type n);
 
-        void reallocate_insert(iterator cur, const value_type &value);
+        void reallocate_insert(pointer cur, const value_type &value);
 
         template<class... Args>
-        void reallocate_emplace(iterator cur, Args &&...args);
+        void reallocate_emplace(pointer cur, Args &&...args);
 
         // 在大小不够，但又继续添加元素的时候使用
         size_type get_new_cap(size_type add_size);
 
+    private:
+        // 分配器支持 reallocate（比如 hugepage_allocator 的 mremap）并且元素可以按位搬移时，
+        // 在尾部插入导致的扩容直接扩展原来的内存，不需要 分配 + 搬移 + 释放
+        static constexpr bool can_expand_in_place =
+                alloc_traits::has_reallocate::value && mystl::is_trivially_relocatable<value_type>::value;
+
+        // 元素可以按位搬移时，扩容、插入时的后移、删除时的前移都只需要一次 memcpy/memmove
+        static constexpr bool relocatable = mystl::is_trivially_relocatable<value_type>::value;
+
+        // 分配至少 cap 个元素的空间，cap 改为分配器实际给出的个数（allocate_at_least），多出的空间计入容量
+        pointer allocate_at_least(size_type &cap) {
+            auto result = alloc_traits::allocate_at_least(data_alloc(), cap);
+            cap = result.count;
+            return result.ptr;
+        }
+
+        // 把容量扩大到 new_cap，元素保持不变，先尝试原地扩展，不行再重新分配
+        void grow_at_end(size_type new_cap);
+
+        // 保证尾部至少还有 n 个备用空间，不够时按增长策略扩容
+        void reserve_back(size_type n);
+
+        // 在尾部用分配器的 construct(p) 构造 n 个元素
+        void default_append(size_type n);
+
+        template<class Iter>
+        pointer range_insert(pointer pos, Iter first, Iter last, mystl::input_iterator_tag);
+
+        template<class Iter>
+        pointer range_insert(pointer pos, Iter first, Iter last, mystl::forward_iterator_tag);
+
+        // 把元素搬到新的空间 new_begin，在下标 xpos 处留出 n 个位置（调用者已经在那里构造好了元素），然后释放原来的空间
+        void relocate_to(pointer new_begin, size_type new_cap, size_type xpos, size_type n);
+
+    public:
+
 
         // ***************************************析构函数
         ~vector() {
@@ -313,14 +504,24 @@ namespace mystl {
 // fill_insert,在insert(pos,n,value)中使用
 // ***************
 
-    template<class T>
-    typename vector<T>::iterator vector<T>::fill_insert(iterator pos, size_type n, const value_type &value) {
+    template<class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::pointer vector<T, Alloc, Growth>::fill_insert(pointer pos, size_type n, const value_type &value) {
         if (n == 0) {
             return pos;
         }
         const size_type xpos = pos - i_begin;
         const value_type value_copy = value; // 避免被覆盖 ，暂时不知道为什
-        if (static_cast<size_type>(i_cap - i_end) >= n) {
+        if (static_cast<size_type>(i_cap - i_end) >= n && relocatable) {
+            // 把 [pos, i_end) 整体后移 n 个位置，空出来的位置直接填充，填充失败时再移回去
+            mystl::uninitialized_relocate(pos, i_end, pos + n);
+            try {
+                mystl::uninitialized_fill_n(pos, n, value_copy);
+            } catch (...) {
+                mystl::uninitialized_relocate(pos + n, i_end + n, pos);
+                throw;
+            }
+            i_end += n;
+        } else if (static_cast<size_type>(i_cap - i_end) >= n) {
             // 当还有更多的备用空间
             const size_type after_elems = i_end - pos;
             auto old_end = i_end;
@@ -336,59 +537,206 @@ namespace mystl {
             }
         } else {
             //备用空间不足
-            const auto new_size = get_new_cap(n);
-            auto new_begin = data_allocator::allocate(new_size);
-            auto new_end = new_begin;
+            auto new_size = get_new_cap(n);
+            if (can_expand_in_place && pos == i_end) {
+                grow_at_end(new_size);
+                i_end = mystl::uninitialized_fill_n(i_end, n, value_copy);
+                return i_begin + xpos;
+            }
+            // 先在新空间中填充新元素，再把原来的元素搬过去
+            auto new_begin = allocate_at_least(new_size);
             try {
-                new_end = mystl::uninitialized_move(i_begin, pos, new_begin);
-                new_end = mystl::uninitialized_fill_n(new_end, n, value);
-                new_end = mystl::uninitialized_move(pos, i_end, new_end);
+                mystl::uninitialized_fill_n(new_begin + xpos, n, value_copy);
             } catch (...) {
-                destrop_and_recover(new_end,new_end,new_size);
-                throw ;
+                data_alloc().deallocate(new_begin, new_size);
+                throw;
             }
-            data_allocator::deallocate(i_begin,i_cap-i_end);
-            i_begin = new_begin;
-            i_end = new_end;
-            i_cap = i_begin + new_size;
+            relocate_to(new_begin, new_size, xpos, n);
         }
         return i_begin + xpos;
     }
 // ***************
+// range_insert input 迭代器的版本，不知道元素个数，先追加到尾部，再通过三次反转把它们旋转到 pos
+// ***************
+    template<class T, class Alloc, class Growth>
+    template<class Iter>
+    typename vector<T, Alloc, Growth>::pointer
+    vector<T, Alloc, Growth>::range_insert(pointer pos, Iter first, Iter last, mystl::input_iterator_tag) {
+        const size_type xpos = pos - i_begin;
+        const size_type old_size = size();
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+        if (xpos != old_size) {
+            mystl::reverse(i_begin + xpos, i_begin + old_size);
+            mystl::reverse(i_begin + old_size, i_end);
+            mystl::reverse(i_begin + xpos, i_end);
+        }
+        return i_begin + xpos;
+    }
+
+// ***************
+// range_insert 前向迭代器的版本，一次算出需要的容量，尾部元素只搬移一次
+// ***************
+    template<class T, class Alloc, class Growth>
+    template<class Iter>
+    typename vector<T, Alloc, Growth>::pointer
+    vector<T, Alloc, Growth>::range_insert(pointer pos, Iter first, Iter last, mystl::forward_iterator_tag) {
+        const size_type xpos = pos - i_begin;
+        const size_type n = static_cast<size_type>(mystl::distance(first, last));
+        if (n == 0) {
+            return pos;
+        }
+        if (static_cast<size_type>(i_cap - i_end) >= n) {
+            // 备用空间足够
+            const pointer old_end = i_end;
+            const size_type after_elems = static_cast<size_type>(old_end - pos);
+            if (relocatable) {
+                // 尾部整体后移 n 个位置，在空出来的位置上拷贝，拷贝失败时移回去
+                mystl::uninitialized_relocate(pos, old_end, pos + n);
+                try {
+                    mystl::uninitialized_copy(first, last, pos);
+                } catch (...) {
+                    mystl::uninitialized_relocate(pos + n, old_end + n, pos);
+                    throw;
+                }
+                i_end += n;
+            } else if (after_elems > n) {
+                i_end = mystl::uninitialized_move(old_end - n, old_end, old_end);
+                mystl::move_backward(pos, old_end - n, old_end);
+                mystl::copy(first, last, pos);
+            } else {
+                auto mid = first;
+                mystl::advance(mid, after_elems);
+                i_end = mystl::uninitialized_copy(mid, last, old_end);
+                i_end = mystl::uninitialized_move(pos, old_end, i_end);
+                mystl::copy(first, mid, pos);
+            }
+            return pos;
+        }
+        // 备用空间不足
+        auto new_cap = get_new_cap(n);
+        if (can_expand_in_place && pos == i_end) {
+            grow_at_end(new_cap);
+            i_end = mystl::uninitialized_copy(first, last, i_end);
+            return i_begin + xpos;
+        }
+        // 先在新空间中拷贝新元素，再把原来的元素搬过去
+        auto new_begin = allocate_at_least(new_cap);
+        try {
+            mystl::uninitialized_copy(first, last, new_begin + xpos);
+        } catch (...) {
+            data_alloc().deallocate(new_begin, new_cap);
+            throw;
+        }
+        relocate_to(new_begin, new_cap, xpos, n);
+        return i_begin + xpos;
+    }
+
+// ***************
 // resize
 // ***************
 
-    template<class T>
-    void vector<T>::resize(size_type new_size, const value_type &value) {
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::resize(size_type new_size, const value_type &value) {
         if (new_size < size()) {
             erase(begin() + new_size, end());
         } else {
             insert(end(), new_size - size(), value);
         }
     }
+
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::resize(size_type new_size) {
+        if (new_size < size()) {
+            erase(begin() + new_size, end());
+        } else {
+            default_append(new_size - size());
+        }
+    }
+
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::resize_uninitialized(size_type new_size) {
+        static_assert(std::is_trivially_default_constructible<value_type>::value &&
+                      std::is_trivially_destructible<value_type>::value,
+                      "resize_uninitialized requires a trivial value_type");
+        if (new_size > size()) {
+            reserve_back(new_size - size());
+        }
+        i_end = i_begin + new_size;
+    }
+
+// ***************
+// reserve_back
+// ***************
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::reserve_back(size_type n) {
+        if (static_cast<size_type>(i_cap - i_end) >= n) {
+            return;
+        }
+        auto new_cap = get_new_cap(n - static_cast<size_type>(i_cap - i_end));
+        if (can_expand_in_place) {
+            grow_at_end(new_cap);
+            return;
+        }
+        auto new_begin = allocate_at_least(new_cap);
+        relocate_to(new_begin, new_cap, size(), 0);
+    }
+
+// ***************
+// default_append
+// ***************
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::default_append(size_type n) {
+        reserve_back(n);
+        pointer cur = i_end;
+        try {
+            for (; n > 0; --n, ++cur) {
+                data_alloc().construct(mystl::address_of(*cur));
+            }
+        } catch (...) {
+            data_alloc().destroy(i_end, cur);
+            throw;
+        }
+        i_end = cur;
+    }
 // ***************
 // erase,删除[first second)上的数据
 // ***************
 
-    template<class T>
-    typename vector<T>::iterator vector<T>::erase(const_iterator first, const_iterator second) {
-        const auto n = first - begin();
-        iterator pos = i_begin + n;
-        data_allocator::destroy(mystl::move(pos + (second - first), i_end, pos), i_end);
-        i_end = i_end - (second - first);
-        return i_begin + n;
+    template<class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase(const_iterator first, const_iterator second) {
+        pointer pos = to_ptr(first);
+        pointer last = to_ptr(second);
+        MYSTL_HARDENING_ASSERT(i_begin <= pos && pos <= last && last <= i_end, "vector::erase range out of range");
+        const auto n = pos - i_begin;
+        if (relocatable) {
+            // 先析构被删除的元素，再把后面的元素整体前移
+            data_alloc().destroy(pos, last);
+            mystl::uninitialized_relocate(last, i_end, pos);
+        } else {
+            data_alloc().destroy(mystl::move(last, i_end, pos), i_end);
+        }
+        i_end = i_end - (last - pos);
+        return to_iter(i_begin + n);
     }
 // ***************
 // erase,在第n个位置擦出
 // ***************
 
-    template<class T>
-    typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
-        iterator cur = i_begin + (pos - begin());
-        mystl::move(cur + 1, i_end, cur);
-        data_allocator::destroy(i_end - 1);
+    template<class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::erase(const_iterator pos) {
+        pointer cur = to_ptr(pos);
+        MYSTL_HARDENING_ASSERT(i_begin <= cur && cur < i_end, "vector::erase position out of range");
+        if (relocatable) {
+            data_alloc().destroy(cur);
+            mystl::uninitialized_relocate(cur + 1, i_end, cur);
+        } else {
+            mystl::move(cur + 1, i_end, cur);
+            data_alloc().destroy(i_end - 1);
+        }
         i_end--;
-        return cur;
+        return to_iter(cur);
     }
 
 
@@ -396,77 +744,144 @@ namespace mystl {
 // insert,在第n个位置插入
 // ***************
 
-    template<class T>
-    typename vector<T>::iterator vector<T>::insert(const_iterator cur, const value_type &value) {
-        std::cout << "insert(const_iterator cur, const value_type &value)" << std::endl;
-        iterator pos = const_cast<iterator>(cur);
-        const size_type n = cur - i_begin;
+    template<class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(const_iterator cur, const value_type &value) {
+        pointer pos = to_ptr(cur);
+        MYSTL_HARDENING_ASSERT(i_begin <= pos && pos <= i_end, "vector::insert position out of range");
+        const size_type n = pos - i_begin;
         // size和capacity不一样，且在最后插入
         if (i_end != i_cap && pos == i_end) {
-            data_allocator::construct(mystl::address_of(*i_end), value);
+            data_alloc().construct(mystl::address_of(*i_end), value);
             i_end++;
+            // 可以按位搬移时，把 [pos, i_end) 整体后移一位，再在 pos 处构造
+        } else if (i_end != i_cap && relocatable) {
+            // value 可能就是后移的元素之一，它的地址也要跟着后移
+            const value_type *src = mystl::address_of(value);
+            if (pos <= src && src < i_end) {
+                ++src;
+            }
+            mystl::uninitialized_relocate(pos, i_end, pos + 1);
+            try {
+                data_alloc().construct(mystl::address_of(*pos), *src);
+            } catch (...) {
+                mystl::uninitialized_relocate(pos + 1, i_end + 1, pos);
+                throw;
+            }
+            ++i_end;
             // size和capacity不一样，但不再最后插入
         } else if (i_end != i_cap) {
+            // value 可能就是后移的元素之一，先拷贝一份
+            value_type value_copy = value;
             auto new_end = i_end;
             // 先将原来最后一个数字向后移动一位
-            data_allocator::construct(mystl::address_of(*i_end), *(i_end - 1));
+            data_alloc().construct(mystl::address_of(*i_end), *(i_end - 1));
             new_end++;
             // 将中间部分向后移动
             mystl::copy_backward(pos, i_end - 1, i_end);
             // 在pos处添加
-            *pos = mystl::move(value);
+            *pos = mystl::move(value_copy);
             i_end = new_end;
             // size == capacity 但不在最后插入
         } else {
             reallocate_insert(pos, value);
         }
 
-        return i_begin + n;
+        return to_iter(i_begin + n);
 
     }
 
 // ***************
 // insert
 // ***************
-    template<class T>
+    template<class T, class Alloc, class Growth>
     template<class... Args>
-    typename vector<T>::iterator vector<T>::emplace(const_iterator cur, Args &&...args) {
-        iterator pos = const_cast<iterator>(cur);
-        const size_type n = cur - i_begin;
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::emplace(const_iterator cur, Args &&...args) {
+        pointer pos = to_ptr(cur);
+        MYSTL_HARDENING_ASSERT(i_begin <= pos && pos <= i_end, "vector::emplace position out of range");
+        const size_type n = pos - i_begin;
 
         if (i_end != i_cap && pos == i_end) {
-            data_allocator::construct(mystl::address_of(*i_end), mystl::forward<Args>(args)...);
+            data_alloc().construct(mystl::address_of(*i_end), mystl::forward<Args>(args)...);
             i_end++;
+        } else if (i_end != i_cap && relocatable) {
+            // args 可能引用后移的元素，先构造出新元素
+            value_type value(mystl::forward<Args>(args)...);
+            mystl::uninitialized_relocate(pos, i_end, pos + 1);
+            try {
+                data_alloc().construct(mystl::address_of(*pos), mystl::move(value));
+            } catch (...) {
+                mystl::uninitialized_relocate(pos + 1, i_end + 1, pos);
+                throw;
+            }
+            ++i_end;
         } else if (i_end != i_cap) {
+            value_type value(mystl::forward<Args>(args)...);
             auto new_end = i_end;
-            data_allocator::construct(mystl::address_of(*i_end), *(i_end - 1));
+            data_alloc().construct(mystl::address_of(*i_end), *(i_end - 1));
             new_end++;
             mystl::copy_backward(pos, i_end - 1, i_end);
-            *pos = value_type(mystl::forward<Args>(args)...);
+            *pos = mystl::move(value);
             i_end = new_end;
         } else {
             reallocate_emplace(pos, mystl::forward<Args>(args)...);
         }
-        return begin() + n;
+        return to_iter(i_begin + n);
     }
 
 
 // ***************
-// get_new_cap 计算在原来基础上，添加add_size个元素，则最后应该多少空间，windows不是2倍扩充，是 a->(a+a/2),linux是2倍扩充
+// get_new_cap 计算在原来基础上，添加add_size个元素，则最后应该多少空间，由增长策略 Growth 决定
 // ***************
-    template<class T>
-    typename vector<T>::size_type vector<T>::get_new_cap(size_type add_size) {
-        const auto old_size = capacity();
+    template<class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::size_type vector<T, Alloc, Growth>::get_new_cap(size_type add_size) {
+        const auto old_cap = capacity();
+        if (add_size > max_size() - old_cap) {
+            throw std::length_error("vector<T> too long");
+        }
+        return Growth::grow(old_cap, old_cap + add_size, max_size(), sizeof(value_type));
+    }
 
-        if (old_size > max_size() - old_size / 2) {
-            return old_size + add_size > max_size() - 16
-                   ? old_size + add_size : old_size + add_size + 16;
+// ***************
+// reserve
+// ***************
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::reserve(size_type n) {
+        if (n <= capacity()) {
+            return;
+        }
+        if (n > max_size()) {
+            throw std::length_error("n can not larger than max_size() in vector<T>::reserve(n)");
+        }
+        size_type new_cap = Growth::fit(n, sizeof(value_type));
+        auto new_begin = allocate_at_least(new_cap);
+        relocate_to(new_begin, new_cap, size(), 0);
+    }
+
+// ***************
+// shrink_to_fit
+// ***************
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::shrink_to_fit() {
+        if (empty()) {
+            if (i_begin != nullptr) {
+                destrop_and_recover(i_begin, i_end, i_cap - i_begin);
+                i_begin = i_end = i_cap = nullptr;
+                invalidate_iterators();
+            }
+            return;
+        }
+        size_type new_cap = Growth::fit(size(), sizeof(value_type));
+        if (new_cap >= capacity()) {
+            return;
+        }
+        // allocate_at_least 可能上调到和原来一样大（比如落在同一个 malloc 大小类中），这时搬过去没有意义，
+        // 直接释放新空间，元素和迭代器都不受影响
+        auto new_begin = allocate_at_least(new_cap);
+        if (new_cap >= capacity()) {
+            data_alloc().deallocate(new_begin, new_cap);
+            return;
         }
-        // 考虑push前，之前的大小是否为0
-        const size_type new_size = old_size == 0
-                                   ? mystl::max(add_size, static_cast<size_type>(16))
-                                   : mystl::max(old_size + old_size, old_size + add_size);
-        return new_size;
+        relocate_to(new_begin, new_cap, size(), 0);
     }
 
 
@@ -474,66 +889,116 @@ namespace mystl {
 // reallocate_insert 在push_back中使用，若空间不足，先重新分配，再添加值
 // ***************
 
-    template<class T>
-    void vector<T>::reallocate_insert(iterator cur, const value_type &value) {
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::reallocate_insert(pointer cur, const value_type &value) {
         // 比如原来的size为30，capacity为30，则加一个之后，capacity为60,
-        // 然后生成一个60capacity的vector
-        // 此时cur为i_end，把[i_begin,cur)的值给新的vector，然后最后一个加上value
-        // 最后把之前的vector的[cur,i_end)的值给新的vector
-        const auto new_capacity = get_new_cap(1);
-        auto new_i_begin = data_allocator::allocate(new_capacity);
-        //auto new_i_end = new_i_begin;
-
-        // 把[i_begin,cur)移动到new_i_begin开始的位置，返回移动结束的位置
-        auto new_i_end = mystl::uninitialized_move(i_begin, cur, new_i_begin);
-        // *new_i_end = value;(这句话等价下面的一行代码)
-        data_allocator::construct(mystl::address_of(*new_i_end), value);
-        ++new_i_end;
-
-        new_i_end = mystl::uninitialized_move(cur, i_end, new_i_end);
-
-        destrop_and_recover(i_begin, i_end, i_cap - i_begin); // 把之前的vector去掉
-        i_begin = new_i_begin;
-        i_end = new_i_end;
-        i_cap = new_i_begin + new_capacity;
+        // 先在新空间的对应位置构造 value，再把原来的元素搬过去，这样 value 是 vector 中的元素时也不会失效
+        MYSTL_TRACE_SCOPE("vector::reallocate_insert", this, capacity());
+        auto new_capacity = get_new_cap(1);
+        // value 可能就是 vector 中的元素，扩展之后原来的地址失效，所以先拷贝一份
+        if (can_expand_in_place && cur == i_end) {
+            value_type value_copy = value;
+            grow_at_end(new_capacity);
+            data_alloc().construct(mystl::address_of(*i_end), mystl::move(value_copy));
+            ++i_end;
+            return;
+        }
+        const size_type xpos = cur - i_begin;
+        auto new_i_begin = allocate_at_least(new_capacity);
+        try {
+            data_alloc().construct(mystl::address_of(*(new_i_begin + xpos)), value);
+        } catch (...) {
+            data_alloc().deallocate(new_i_begin, new_capacity);
+            throw;
+        }
+        relocate_to(new_i_begin, new_capacity, xpos, 1);
     }
 
 // ***************
 // reallocate_emplace 在emplace_back中使用，若空间不足，先重新分配，再添加值
 // ***************
 
-    template<class T>
+    template<class T, class Alloc, class Growth>
     template<class... Args>
-    void vector<T>::reallocate_emplace(vector::iterator cur, Args &&... args) {
-        const auto new_capacity = get_new_cap(1);
-        auto new_i_begin = data_allocator::allocate(new_capacity);
-        //auto new_i_end = new_i_begin;
-
-        // 把[i_begin,cur)移动到new_i_begin开始的位置，返回移动结束的位置
-        auto new_i_end = mystl::uninitialized_move(i_begin, cur, new_i_begin);
-        data_allocator::construct(mystl::address_of(*new_i_end), mystl::forward<Args>(args)...);
-        ++new_i_end;
-
-        new_i_end = mystl::uninitialized_move(cur, i_end, new_i_end);
+    void vector<T, Alloc, Growth>::reallocate_emplace(pointer cur, Args &&... args) {
+        MYSTL_TRACE_SCOPE("vector::reallocate_emplace", this, capacity());
+        auto new_capacity = get_new_cap(1);
+        if (can_expand_in_place && cur == i_end) {
+            value_type value(mystl::forward<Args>(args)...);
+            grow_at_end(new_capacity);
+            data_alloc().construct(mystl::address_of(*i_end), mystl::move(value));
+            ++i_end;
+            return;
+        }
+        const size_type xpos = cur - i_begin;
+        auto new_i_begin = allocate_at_least(new_capacity);
+        try {
+            data_alloc().construct(mystl::address_of(*(new_i_begin + xpos)), mystl::forward<Args>(args)...);
+        } catch (...) {
+            data_alloc().deallocate(new_i_begin, new_capacity);
+            throw;
+        }
+        relocate_to(new_i_begin, new_capacity, xpos, 1);
+    }
 
-        destrop_and_recover(i_begin, i_end, i_cap - i_begin); // 把之前的vector去掉
-        i_begin = new_i_begin;
-        i_end = new_i_end;
-        i_cap = new_i_begin + new_capacity;
+// ***************
+// grow_at_end 扩大容量，只在 can_expand_in_place 为真时使用，元素可以按位搬移
+// ***************
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::grow_at_end(size_type new_cap) {
+        const size_type old_size = size();
+        auto new_begin = alloc_traits::reallocate(data_alloc(), i_begin, capacity(), new_cap);
+        if (new_begin == nullptr) {
+            auto fresh = allocate_at_least(new_cap);
+            relocate_to(fresh, new_cap, old_size, 0);
+            return;
+        }
+        i_begin = new_begin;
+        i_end = new_begin + old_size;
+        i_cap = new_begin + new_cap;
+        invalidate_iterators();
+    }
 
+// ***************
+// relocate_to 扩容时使用，可以按位搬移的元素只需要两次 memcpy，其它元素逐个移动之后析构原来的
+// ***************
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::relocate_to(pointer new_begin, size_type new_cap, size_type xpos, size_type n) {
+        const size_type old_size = size();
+        if (relocatable) {
+            mystl::uninitialized_relocate(i_begin, i_begin + xpos, new_begin);
+            mystl::uninitialized_relocate(i_begin + xpos, i_end, new_begin + xpos + n);
+            destrop_and_recover(i_begin, i_begin, i_cap - i_begin); // 元素已经搬走，只释放空间
+        } else {
+            pointer new_end = new_begin;
+            try {
+                new_end = mystl::uninitialized_move(i_begin, i_begin + xpos, new_begin);
+                mystl::uninitialized_move(i_begin + xpos, i_end, new_end + n);
+            } catch (...) {
+                data_alloc().destroy(new_begin, new_end);
+                data_alloc().destroy(new_begin + xpos, new_begin + xpos + n);
+                data_alloc().deallocate(new_begin, new_cap);
+                throw;
+            }
+            destrop_and_recover(i_begin, i_end, i_cap - i_begin);
+        }
+        i_begin = new_begin;
+        i_end = new_begin + old_size + n;
+        i_cap = new_begin + new_cap;
+        invalidate_iterators();
     }
 
 // ***************
 // push_back
 // ***************
 
-    template<class T>
-    void vector<T>::push_back(const value_type &value) {
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::push_back(const value_type &value) {
         // 考虑添加元素后，是否超过空间
         // 可以直接添加元素
         if (i_end != i_cap) {
             // address_of会返回i_end的地址，然后construct构造value
-            data_allocator::construct(mystl::address_of(*i_end), value);
+            data_alloc().construct(mystl::address_of(*i_end), value);
             i_end++;
         }
             // 先扩容再添加
@@ -545,11 +1010,11 @@ namespace mystl {
 // ***************
 // emplace_back
 // ***************
-    template<class T>
+    template<class T, class Alloc, class Growth>
     template<class... Args>
-    void vector<T>::emplace_back(Args &&... args) {
+    void vector<T, Alloc, Growth>::emplace_back(Args &&... args) {
         if (i_end != i_cap) {
-            data_allocator::construct(mystl::address_of(*i_end), mystl::forward<Args>(args)...);
+            data_alloc().construct(mystl::address_of(*i_end), mystl::forward<Args>(args)...);
             i_end++;
         } else {
             reallocate_emplace(i_end, mystl::forward<Args>(args)...);
@@ -560,35 +1025,58 @@ namespace mystl {
 // ***************
 // destrop_and_recover 收回空间，析构函数使用
 // ***************
-    template<class T>
-    void vector<T>::destrop_and_recover(iterator first, iterator last, size_type n) {
-        data_allocator::destroy(first, last);
-        data_allocator::deallocate(first, n);
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::destrop_and_recover(pointer first, pointer last, size_type n) {
+        // 使用 arena 这类分配器并且元素可以平凡析构时，整个过程什么都不需要做
+        if (alloc_traits::can_skip_destroy) {
+            return;
+        }
+        data_alloc().destroy(first, last);
+        data_alloc().deallocate(first, n);
     }
 
 
 // ***************
 // swap,让自己和另一个vector交换，达到operator=操作
 // ***************
-    template<class T>
-    void vector<T>::swap(vector &rhs) noexcept {
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::swap(vector &rhs) noexcept {
         // 不一样才交换
         if (this != &rhs) {
-            i_begin = rhs.i_begin;
-            i_end = rhs.i_end;
-            i_cap = rhs.i_cap;
+            mystl::swap(i_begin, rhs.i_begin);
+            mystl::swap(i_end, rhs.i_end);
+            mystl::swap(i_cap, rhs.i_cap);
+            invalidate_iterators();
+            rhs.invalidate_iterators();
+            // 不传播时要求两个分配器相等，否则行为未定义（和标准库一致）
+            if (alloc_traits::propagate_on_container_swap::value) {
+                mystl::swap(data_alloc(), rhs.data_alloc());
+            }
         }
     }
 
+// ***************
+// swap_all,数据和分配器都交换
+// ***************
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::swap_all(vector &rhs) noexcept {
+        mystl::swap(i_begin, rhs.i_begin);
+        mystl::swap(i_end, rhs.i_end);
+        mystl::swap(i_cap, rhs.i_cap);
+        mystl::swap(data_alloc(), rhs.data_alloc());
+        invalidate_iterators();
+        rhs.invalidate_iterators();
+    }
+
 
 // ***************
 // 操作符= std::initializer_list<value_type>赋值
 // ***************
 
-    template<class T>
-    vector<T> &vector<T>::operator=(std::initializer_list<value_type> ilist) {
-        vector temp(ilist.begin(), ilist.end());
-        swap(temp);
+    template<class T, class Alloc, class Growth>
+    vector<T, Alloc, Growth> &vector<T, Alloc, Growth>::operator=(std::initializer_list<value_type> ilist) {
+        vector temp(ilist.begin(), ilist.end(), get_allocator());
+        swap_all(temp);
         return *this;
     }
 
@@ -598,12 +1086,16 @@ namespace mystl {
 // 操作符= 拷贝赋值
 // ***************
 
-    template<class T>
-    vector<T> &vector<T>::operator=(const vector &rhs) {
+    template<class T, class Alloc, class Growth>
+    vector<T, Alloc, Growth> &vector<T, Alloc, Growth>::operator=(const vector &rhs) {
         // 判断是否是一个东西，通过判断地址
         if (this != &rhs) {
-            vector temp(rhs.begin(), rhs.end());
-            swap(temp);
+            // propagate_on_container_copy_assignment 为真时使用rhs的分配器，否则保留自己的
+            // temp和自己交换数据和分配器之后，原来的数据由原来的分配器释放
+            const allocator_type alloc = alloc_traits::propagate_on_container_copy_assignment::value
+                                         ? rhs.get_allocator() : get_allocator();
+            vector temp(rhs.i_begin, rhs.i_end, alloc);
+            swap_all(temp);
         }
         return *this;
     }
@@ -611,72 +1103,67 @@ namespace mystl {
 // 操作符= 移动赋值
 // ***************
 
-    template<class T>
-    vector<T> &vector<T>::operator=(vector &&rhs) {
+    template<class T, class Alloc, class Growth>
+    vector<T, Alloc, Growth> &vector<T, Alloc, Growth>::operator=(vector &&rhs)
+    noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
         // 判断是否是一个东西，通过判断地址
         if (this != &rhs) {
-            vector temp(rhs.begin(), rhs.end());
-            swap(temp);
-            rhs.i_begin = nullptr;
-            rhs.i_end = nullptr;
-            rhs.i_cap = nullptr;
+            if (alloc_traits::propagate_on_container_move_assignment::value ||
+                alloc_traits::equal(data_alloc(), rhs.data_alloc())) {
+                // 可以直接接管rhs的内存，原来的数据交给temp析构
+                vector temp(mystl::move(rhs));
+                swap_all(temp);
+                if (!alloc_traits::propagate_on_container_move_assignment::value) {
+                    // 不传播时保留自己原来的分配器（两者相等）
+                    mystl::swap(data_alloc(), temp.data_alloc());
+                }
+            } else {
+                // 分配器不相等，只能用自己的分配器逐个移动元素
+                // 全部移动构造成功之后才设置 i_end，中途抛出异常时 temp 中没有元素
+                vector temp(rhs.size(), get_allocator(), no_init_tag());
+                temp.i_end = mystl::uninitialized_move(rhs.i_begin, rhs.i_end, temp.i_begin);
+                swap_all(temp);
+                rhs.clear();
+            }
         }
         return *this;
     }
 
 // ***************
-// reverse 将容量转为n个,要判断capacity的大小，若小于n，则扩大到n，用0填充，若大于n，则保留前n个
+// reverse 将容量转为n个,若原来的元素多于n个，则保留前n个
 // ***************
 
-    template<class T>
-    void vector<T>::reverse(size_type n) {
-        if (capacity() < n) {
-            const auto old_size = size();
-            auto temp = data_allocator::allocate(n);
-            mystl::uninitialized_move(i_begin, i_end, temp);
-            data_allocator::deallocate(i_begin, i_cap - i_begin);//把原来的空间给清楚掉
-            i_begin = temp;
-            i_end = i_begin + old_size;
-            i_cap = i_begin + n;
-        } else {
-            if (size() < n) {
-                const auto old_size = size();
-                auto temp = data_allocator::allocate(n);
-                mystl::uninitialized_move(i_begin, i_begin + n, temp);
-                data_allocator::deallocate(i_begin, i_cap - i_begin);//把原来的空间给清楚掉
-                i_begin = temp;
-                i_end = i_begin + old_size;
-                i_cap = i_begin + n;
-            } else {
-                auto temp = data_allocator::allocate(n);
-                mystl::uninitialized_move(i_begin, i_begin + n, temp);
-                data_allocator::deallocate(i_begin, i_cap - i_begin);//把原来的空间给清楚掉
-                i_begin = temp;
-                i_end = i_begin + n;
-                i_cap = i_begin + n;
-            }
-
-        }
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::reverse(size_type n) {
+        // 原来的元素多于 n 个时只保留前 n 个，然后搬到大小为 n 的新空间
+        const size_type keep = size() < n ? size() : n;
+        data_alloc().destroy(i_begin + keep, i_end);
+        i_end = i_begin + keep;
+        auto new_begin = allocate_at_least(n);
+        relocate_to(new_begin, n, keep, 0);
     }
 
 // ***************
 // range_init 分配cap和last-first，同时拷贝first到last的值到i_begin
 // ***************
-    template<class T>
+    template<class T, class Alloc, class Growth>
     template<class Iter>
-    void vector<T>::range_init(Iter first, Iter last) {
-        const size_type init_size = mystl::max(static_cast<size_type>(16), static_cast<size_type>(last - first));
-        init_space(static_cast<size_type>(last - first), init_size);
+    void vector<T, Alloc, Growth>::range_init(Iter first, Iter last) {
+        init_space(static_cast<size_type>(last - first), init_cap(static_cast<size_type>(last - first)));
         mystl::uninitialized_copy(first, last, i_begin);
     }
 
 // ***************
 // init_space ,分配cap和n
 // ***************
-    template<class T>
-    void vector<T>::init_space(size_type n, size_type cap) {
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::init_space(size_type n, size_type cap) {
+        if (cap == 0) {
+            i_begin = i_end = i_cap = nullptr;
+            return;
+        }
         try {
-            i_begin = data_allocator::allocate(cap);
+            i_begin = allocate_at_least(cap);
             i_end = i_begin + n;
             i_cap = i_begin + cap;
         }
@@ -689,33 +1176,38 @@ namespace mystl {
     }
 
 // ***************
-// fill_init  若设置的n小于16，则创建16的cap，然后创建n个T，值为value
+// fill_init  容量为 init_cap(n)（默认最小 16），然后创建n个T，值为value
 // ***************
-    template<class T>
-    void vector<T>::fill_init(size_type n, const value_type &value) {
-        const size_type init_size = mystl::max(static_cast<size_type>(16), n);
-        init_space(n, init_size);
+    template<class T, class Alloc, class Growth>
+    void vector<T, Alloc, Growth>::fill_init(size_type n, const value_type &value) {
+        init_space(n, init_cap(n));
         mystl::uninitialized_fill_n(i_begin, n, value);
     }
 
 
-// ***************
-// try_init  // 分配16个sizeof（T）
-// ***************
-    template<class T>
-    void vector<T>::try_init() noexcept {
-        try {
-            i_begin = data_allocator::allocate(16);
-            i_end = i_begin;
-            i_cap = i_begin + 16;
-        }
-        catch (...) {
-            i_begin = nullptr;
-            i_end = nullptr;
-            i_cap = nullptr;
-        }
+    // erase(v, value) 删除所有等于 value 的元素，erase_if(v, pred) 删除所有 pred 为真的元素，一遍完成，返回删除的个数
+    template<class T, class Alloc, class Growth, class U>
+    typename vector<T, Alloc, Growth>::size_type erase(vector<T, Alloc, Growth> &v, const U &value) {
+        auto it = mystl::remove(v.begin(), v.end(), value);
+        const auto n = static_cast<typename vector<T, Alloc, Growth>::size_type>(v.end() - it);
+        v.erase(it, v.end());
+        return n;
+    }
 
+    template<class T, class Alloc, class Growth, class Pred>
+    typename vector<T, Alloc, Growth>::size_type erase_if(vector<T, Alloc, Growth> &v, Pred pred) {
+        auto it = mystl::remove_if(v.begin(), v.end(), pred);
+        const auto n = static_cast<typename vector<T, Alloc, Growth>::size_type>(v.end() - it);
+        v.erase(it, v.end());
+        return n;
     }
 
+    // 使用多态内存资源的vector，polymorphic_allocator 定义在 memory_resource.h 中，使用时需要包含它
+    namespace pmr {
+        template<class T>
+        class polymorphic_allocator;
 
-}
\ No newline at end of file
+        template<class T>
+        using vector = mystl::vector<T, polymorphic_allocator<T>>;
+    }
+}